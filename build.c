@@ -12,14 +12,24 @@ int main() {
 
     char *source_files[][2] = {
         {"src/ast.cpp", "out/build/ast.o"},
+        {"src/cache.cpp", "out/build/cache.o"},
         {"src/codegen.cpp", "out/build/codegen.o"},
+        {"src/constant_folding.cpp", "out/build/constant_folding.o"},
+        {"src/dead_code.cpp", "out/build/dead_code.o"},
         {"src/diagnostics.cpp", "out/build/diagnostics.o"},
+        {"src/driver.cpp", "out/build/driver.o"},
+        {"src/escape_analysis.cpp", "out/build/escape_analysis.o"},
         {"src/lexer.cpp", "out/build/lexer.o"},
+        {"src/linker.cpp", "out/build/linker.o"},
         {"src/main.cpp", "out/build/main.o"},
+        {"src/module_build.cpp", "out/build/module_build.o"},
         {"src/parser.cpp", "out/build/parser.o"},
         {"src/semantic_analyzer.cpp", "out/build/semantic_analyzer.o"},
+        {"src/server.cpp", "out/build/server.o"},
         {"src/std.cpp", "out/build/std.o"},
         {"src/symbol_table.cpp", "out/build/symbol_table.o"},
+        {"src/tail_recursion.cpp", "out/build/tail_recursion.o"},
+        {"src/thread_pool.cpp", "out/build/thread_pool.o"},
         {"src/token.cpp", "out/build/token.o"},
         {"src/types.cpp", "out/build/types.o"},
     };
@@ -51,10 +61,12 @@ int main() {
          "-DEXPERIMENTAL_KEY_INSTRUCTIONS", "-D__STDC_CONSTANT_MACROS",
          "-D__STDC_FORMAT_MACROS", "-D__STDC_LIMIT_MACROS", "--sysroot",
          "$(xcrun --show-sdk-path)", "-L/opt/homebrew/opt/llvm/lib",
-         "out/build/ast.o", "out/build/codegen.o", "out/build/diagnostics.o",
-         "out/build/lexer.o", "out/build/main.o", "out/build/parser.o",
-         "out/build/semantic_analyzer.o", "out/build/std.o",
-         "out/build/symbol_table.o", "out/build/token.o", "out/build/types.o",
+         "out/build/ast.o", "out/build/cache.o", "out/build/codegen.o", "out/build/constant_folding.o",
+         "out/build/dead_code.o", "out/build/diagnostics.o", "out/build/driver.o", "out/build/escape_analysis.o", "out/build/lexer.o",
+         "out/build/linker.o", "out/build/main.o", "out/build/module_build.o", "out/build/parser.o",
+         "out/build/semantic_analyzer.o", "out/build/server.o", "out/build/std.o",
+         "out/build/symbol_table.o", "out/build/tail_recursion.o", "out/build/thread_pool.o",
+         "out/build/token.o", "out/build/types.o",
          "runtime/std.a", "-lLLVM", "-o", "out/bin/risc");
 
     if (!run(&cmd)) return EXIT_FAILURE;
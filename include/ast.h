@@ -70,13 +70,43 @@ public:
     void accept(class ASTVisitor& visitor) override;
 };
 
+// Source annotation written before a loop or function, such as @unroll(4),
+// @vectorize(width=8) or @cold. Positional arguments have an empty key.
+struct Annotation {
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> arguments; // (key, value) pairs
+    SourcePos position;
+};
+
+inline bool has_annotation(const std::vector<Annotation>& annotations, const std::string& name) {
+    for (const auto& annotation : annotations) {
+        if (annotation.name == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// What calling a function may do besides producing its result
+enum class FunctionPurity {
+    SideEffects, // Writes memory, allocates or performs I/O
+    ReadOnly,    // Reads globals or list/string contents, writes nothing
+    Pure,        // Result depends on the arguments alone
+};
+
 // Function declaration
 class FuncDecl : public ASTNode {
 public:
     std::string name;
     std::string return_type;
     std::vector<std::pair<std::string, std::string>> parameters; // (type, name) pairs
-    std::unique_ptr<BlockStmt> body;
+    std::unique_ptr<BlockStmt> body; // Null for a prototype
+    std::vector<Annotation> annotations; // @inline, @noinline, @hot, @cold, @flatten
+    bool is_const = false; // Declared `const`: calls with constant arguments run at compile time
+    
+    // Inferred by semantic analysis over the call graph
+    FunctionPurity purity = FunctionPurity::SideEffects;
+    bool always_returns = false; // No loops and no recursion, so every call finishes
     
     FuncDecl(const std::string& n, const std::string& ret_type, const SourcePos& pos)
         : ASTNode(pos), name(n), return_type(ret_type) {}
@@ -90,6 +120,7 @@ public:
     std::string name;
     std::string type;
     std::unique_ptr<Expr> initializer;
+    bool constant_data = false; // Global list never written after initialization; set by fold_constants
     
     VarDecl(const std::string& n, const std::string& t, const SourcePos& pos)
         : Stmt(pos), name(n), type(t) {}
@@ -125,6 +156,7 @@ class WhileStmt : public Stmt {
 public:
     std::unique_ptr<Expr> condition;
     std::unique_ptr<Stmt> body;
+    std::vector<Annotation> annotations; // Loop hints, lowered to llvm.loop metadata
     
     WhileStmt(std::unique_ptr<Expr> cond, const SourcePos& pos)
         : Stmt(pos), condition(std::move(cond)) {}
@@ -139,6 +171,7 @@ public:
     std::unique_ptr<Expr> condition; // nullptr if no condition
     std::unique_ptr<Expr> update; // nullptr if no update
     std::unique_ptr<Stmt> body;
+    std::vector<Annotation> annotations; // Loop hints, lowered to llvm.loop metadata
     
     ForStmt(const SourcePos& pos) : Stmt(pos) {}
     
@@ -211,6 +244,7 @@ public:
     std::unique_ptr<Expr> left;
     std::unique_ptr<Expr> right;
     TokenType op;
+    std::string list_element_type; // Set by semantic analysis when == or != compares two lists
     
     BinaryExpr(std::unique_ptr<Expr> l, std::unique_ptr<Expr> r, TokenType o, const SourcePos& pos)
         : Expr(pos), left(std::move(l)), right(std::move(r)), op(o) {}
@@ -282,6 +316,7 @@ public:
 class ListLiteralExpr : public Expr {
 public:
     std::vector<std::unique_ptr<Expr>> elements;
+    bool stack_allocated = false; // Initializes a local that never escapes; set by mark_stack_lists
     
     ListLiteralExpr(const SourcePos& pos) : Expr(pos) {}
     
@@ -293,6 +328,7 @@ class ListIndexExpr : public Expr {
 public:
     std::unique_ptr<Expr> list;
     std::unique_ptr<Expr> index;
+    std::string element_type; // The list's element type, set by semantic analysis
     
     ListIndexExpr(std::unique_ptr<Expr> l, std::unique_ptr<Expr> i, const SourcePos& pos)
         : Expr(pos), list(std::move(l)), index(std::move(i)) {}
@@ -304,8 +340,9 @@ public:
 class ListMethodCallExpr : public Expr {
 public:
     std::unique_ptr<Expr> list;
-    std::string method_name; // "push", "pop", "size"
+    std::string method_name; // "push", "pop", "size", "reserve", "resize", "fill", "clear", "extend", "copy"
     std::vector<std::unique_ptr<Expr>> arguments; // for push method
+    std::string element_type; // The list's element type, set by semantic analysis
     
     ListMethodCallExpr(std::unique_ptr<Expr> l, const std::string& method, 
                       std::vector<std::unique_ptr<Expr>> args, const SourcePos& pos)
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "token.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ris {
+
+// Builds a content hash out of everything that influences a build artifact
+class CacheKey {
+public:
+    // Hash the token stream after include expansion. Positions are left out,
+    // so edits to comments and whitespace still hit the cache.
+    void add_tokens(const std::vector<Token>& tokens);
+
+    // Hash the contents of a file (e.g. the runtime library); a missing file hashes as empty
+    void add_file(const std::string& path);
+
+    // Hash any other input: flags, versions, output kind
+    void add(const std::string& field);
+
+    // Hex digest of everything added so far
+    std::string digest() const;
+
+private:
+    std::string data_;
+};
+
+// Directory of build artifacts named by their CacheKey digest. Once the
+// entries outgrow max_size bytes, the least recently used are removed.
+class CompileCache {
+public:
+    explicit CompileCache(std::string directory, uintmax_t max_size = default_max_size());
+
+    // $RISC_CACHE_DIR, else $XDG_CACHE_HOME/risc, else ~/.cache/risc
+    static std::string default_directory();
+
+    // $RISC_CACHE_SIZE megabytes, else 256 MB
+    static uintmax_t default_max_size();
+
+    // Identifies this compiler build, so artifacts never outlive the compiler that made them
+    static std::string compiler_version();
+
+    // Copy the artifact stored under key to destination. Returns false on a miss.
+    bool fetch(const std::string& key, const std::string& destination) const;
+
+    // Store a copy of artifact under key, then evict down to max_size. Safe
+    // against concurrent stores of the same key.
+    void store(const std::string& key, const std::string& artifact) const;
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    // Remove the entries used longest ago until the rest fit in max_size_
+    void evict() const;
+
+    std::string directory_;
+    uintmax_t max_size_;
+};
+
+} // namespace ris
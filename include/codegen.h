@@ -12,17 +12,50 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <vector>
+
+namespace llvm {
+class TargetMachine;
+}
 
 namespace ris {
 
+// Options controlling how a program is lowered and compiled to native code
+struct CodeGenOptions {
+    unsigned jobs = 1;      // Number of modules the functions are split across (-j N)
+    unsigned opt_level = 2; // IR optimization level used before emitting object files
+    bool module_unit = false; // One unit of a separately compiled program: never synthesize main
+    bool pic = true;          // Position-independent code (needed for PIE executables)
+    std::string target_cpu = "generic"; // CPU to tune and select instructions for ("native" = this host)
+    std::string target_features;        // Extra "+feature,-feature" list applied on top of the CPU's
+    bool whole_program = true; // Internalize all but main and optimize across functions (single-partition executables)
+    bool fast_math = false;      // --fast-math: float arithmetic may ignore NaN, infinities, signed zeros and rounding order
+    bool fp_contract = false;    // --fp-contract: a*b+c may become one fused multiply-add
+    bool reassoc = false;        // --reassoc: float sums and products may be reordered, e.g. into vector reductions
+    bool no_signed_wrap = false; // --no-signed-wrap: int overflow is undefined, so + - * and ++ carry nsw
+};
+
 class CodeGenerator {
 public:
-    CodeGenerator();
+    explicit CodeGenerator(const CodeGenOptions& options = CodeGenOptions());
     ~CodeGenerator();
     
-    // Main entry point
+    // Main entry point: write the whole program as textual LLVM IR
     bool generate(std::unique_ptr<Program> program, const std::string& output_file);
     
+    // Compile the program to native object files. With jobs > 1 the functions are
+    // partitioned across that many modules, each optimized and emitted on its own thread.
+    // The written paths (<output_prefix>.<n>.o) are appended to object_files.
+    bool generate_objects(std::unique_ptr<Program> program, const std::string& output_prefix,
+                          std::vector<std::string>& object_files);
+    
+    // The CPU name and feature string the options resolve to on this host.
+    // "native" becomes the host CPU with every feature it reports.
+    static void resolve_target(const CodeGenOptions& options, std::string& cpu, std::string& features);
+    
+    // The arithmetic flags above as one stable string, for cache keys
+    static std::string arithmetic_mode(const CodeGenOptions& options);
+    
     // Error handling
     bool has_error() const { return has_error_; }
     const std::string& error_message() const { return error_message_; }
@@ -32,10 +65,24 @@ public:
     const DiagnosticReporter& get_diagnostics() const { return diagnostics_; }
     
 private:
+    CodeGenOptions options_;
+    
     // LLVM context and modules
     std::unique_ptr<llvm::LLVMContext> context_;
     std::unique_ptr<llvm::Module> module_;
     std::unique_ptr<llvm::IRBuilder<>> builder_;
+    std::unique_ptr<llvm::TargetMachine> target_machine_;
+    
+    // Resolved target, also attached to every defined function
+    std::string target_cpu_;
+    std::string target_features_;
+    
+    // Whether this module is the entire program, so nothing but main is called from outside
+    bool whole_program() const;
+    
+    // Which slice of Program::functions this generator defines (parallel codegen)
+    size_t partition_index_;
+    size_t partition_count_;
     
     // Error handling
     bool has_error_;
@@ -62,10 +109,21 @@ private:
     llvm::Type* get_llvm_type(const Type& type);
     llvm::Type* get_llvm_type(const std::string& type_name);
     
+    // Target setup and native code emission
+    void configure_target();
+    bool verify_module();
+    void optimize_module();
+    bool emit_object(const std::string& object_file);
+    
     // Program generation
     void generate_program(Program& program);
+    bool owns_function(size_t index) const { return index % partition_count_ == partition_index_; }
+    void declare_function(FuncDecl& func);
+    void set_function_hints(llvm::Function* llvm_func, const std::vector<Annotation>& annotations);
     void generate_function(FuncDecl& func);
     void generate_variable_declaration(VarDecl& var, bool is_global = false);
+    void generate_global_initializers(Program& program); // Constants in place, the rest from a module constructor
+    llvm::Constant* generate_constant_list(const std::string& name, ListLiteralExpr& expr); // Read-only table
     void generate_statement(Stmt& stmt);
     void generate_block(BlockStmt& block);
     
@@ -74,13 +132,21 @@ private:
     llvm::Value* generate_literal_expression(LiteralExpr& expr);
     llvm::Value* generate_identifier_expression(IdentifierExpr& expr);
     llvm::Value* generate_binary_expression(BinaryExpr& expr);
+    llvm::Value* generate_binary_operation(TokenType op, llvm::Value* left, llvm::Value* right);
+    llvm::Value* generate_assignment(Expr& target, TokenType op, Expr* value, bool return_old); // =, +=, ++ on a variable or xs[i]
+    llvm::Value* generate_logical_expression(BinaryExpr& expr); // Short-circuit && and ||, as i1
+    llvm::Value* generate_condition(Expr& expr, const std::string& name); // Any expression as an i1 branch condition
     llvm::Value* generate_unary_expression(UnaryExpr& expr);
     llvm::Value* generate_call_expression(CallExpr& expr);
     llvm::Value* generate_generic_print_call(CallExpr& expr);
     llvm::Value* generate_struct_access_expression(StructAccessExpr& expr);
     llvm::Value* generate_list_literal_expression(ListLiteralExpr& expr);
+    llvm::Constant* generate_literal_table(ListLiteralExpr& expr); // Elements as a read-only array, if all literals
+    llvm::Value* generate_list_operand(Expr& expr); // The list indexed by xs[i]
+    llvm::Value* convert_value(llvm::Value* value, llvm::Type* type); // int <-> float, and between int widths
     llvm::Value* generate_list_index_expression(ListIndexExpr& expr);
     llvm::Value* generate_list_method_call_expression(ListMethodCallExpr& expr);
+    llvm::Value* generate_list_bulk_operation(ListMethodCallExpr& expr, llvm::Value* list); // reserve, resize, fill, clear, extend, copy
     llvm::Value* generate_pre_increment_expression(PreIncrementExpr& expr);
     llvm::Value* generate_post_increment_expression(PostIncrementExpr& expr);
     
@@ -88,6 +154,8 @@ private:
     void generate_if_statement(IfStmt& stmt);
     void generate_while_statement(WhileStmt& stmt);
     void generate_for_statement(ForStmt& stmt);
+    void set_loop_hints(llvm::BasicBlock* header, llvm::Instruction* entry_branch,
+                        const std::vector<Annotation>& annotations); // On every back edge to header
     void generate_switch_statement(SwitchStmt& stmt);
     void generate_case_statement(CaseStmt& stmt);
     void generate_break_statement(BreakStmt& stmt);
@@ -97,7 +165,28 @@ private:
     // Utility methods
     llvm::Value* create_constant(const std::string& value, const std::string& type);
     void create_main_function();
+    
+    // Stack slot in the current function's entry block
+    llvm::AllocaInst* create_entry_alloca(llvm::Type* type, const std::string& name = "");
+    
+    // Mark a call whose result is returned immediately as a tail call
+    void mark_tail_call(llvm::Value* ret_value);
+    
+    // Type-based alias tags. Variables, list headers, list slot arrays and the
+    // element cells of each scalar type are disjoint memory, so a store to one
+    // never clobbers a load from another.
+    void set_tbaa(llvm::Value* access, const std::string& type_name);
+    std::string element_tbaa_type(llvm::Type* type) const;
+    
+    // Inline equivalent of a ris_list_get_* getter: null, bounds and element
+    // type checks, then a tagged load of the element
+    llvm::Value* generate_list_get(llvm::Value* list, llvm::Value* index, int element_tag, llvm::Function* getter);
+    llvm::Value* generate_list_store(llvm::Value* list, llvm::Value* index, TokenType op, llvm::Value* operand, bool return_old);
+    void generate_list_push(llvm::Value* list, int element_tag, llvm::Value* value);
+    llvm::StructType* list_header_type(); // ris_list_t
+    
     void declare_runtime_functions();
+    void annotate_runtime_functions(); // What each runtime call may do, for the optimizer
 };
 
 } // namespace ris
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "ast.h"
+#include <cstddef>
+
+namespace ris {
+
+// Replace operators whose operands are all literals with the literal they
+// evaluate to: int, float, bool and char arithmetic, comparisons and logic,
+// and `"a" + "b"`, which would otherwise allocate a new string at run time.
+// `false && e` and `true || e` fold as well, since e is never evaluated.
+//
+// Calls to `const` functions with constant arguments, and global
+// initializers, are run by an interpreter over the AST and replaced by their
+// result, lists of int included. Global int lists that are never written
+// afterwards are marked constant_data for the code generator to emit as
+// read-only tables.
+//
+// Folding follows what the generated code computes: ints wrap at 64 bits and
+// floats round as IEEE doubles. Anything that would fail or trap at run time,
+// such as division by zero, is left alone. Runs on an analyzed program;
+// returns the number of expressions replaced.
+size_t fold_constants(Program& program);
+
+} // namespace ris
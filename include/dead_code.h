@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ast.h"
+#include <cstddef>
+
+namespace ris {
+
+// Drop the functions and globals a program never uses. Starting from main,
+// every function it calls and every global it names is kept, transitively,
+// through the bodies of those functions and the initializers of those
+// globals. Everything else, typically the bulk of an included library, is
+// removed before code generation.
+//
+// A global whose initializer has side effects, such as printing, is kept
+// even when unused, since its initializer runs at startup. Programs without
+// a main are left alone. Runs on an analyzed program, so errors in unused
+// code are still reported; returns the number of declarations removed.
+size_t remove_unused_declarations(Program& program);
+
+} // namespace ris
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "codegen.h"
+#include "linker.h"
+#include <string>
+#include <vector>
+
+namespace ris {
+
+// One source file to compile and where its result should go
+struct CompileJob {
+    std::string input_file;
+    std::string output_file; // Empty = derived from the input stem
+    bool emit_llvm = false;  // Write LLVM IR instead of linking an executable
+};
+
+// Settings shared by every job of a single risc invocation
+struct DriverOptions {
+    CodeGenOptions codegen;
+    unsigned jobs = 1;      // Number of files compiled concurrently
+    unsigned sema_jobs = 0; // Function bodies checked concurrently per file (0 = default)
+    bool verbose = false;
+    bool static_link = false; // --static
+    bool pie = true;          // Cleared by --no-pie
+    bool tail_loops = false;  // --tail-loops: rewrite self tail recursion into loops
+    std::string working_dir; // Relative paths are resolved against this (empty = current directory)
+    std::string cache_dir;   // Compile cache for executables (empty = caching disabled)
+};
+
+// Outcome of one job. Messages are buffered so concurrent jobs never interleave.
+struct CompileResult {
+    bool ok = false;
+    std::string output_file; // Executable or IR file that was written
+    std::string log;         // Progress messages (stdout)
+    std::string errors;      // Error messages (stderr)
+};
+
+// Compile a single file. Safe to call from several threads at once: every
+// job works in its own LLVM context and its own private temp directory.
+CompileResult compile_file(const CompileJob& job, const DriverOptions& options);
+
+// Linker settings for an invocation's executables
+LinkOptions link_options(const DriverOptions& options);
+
+// Resolve a path from the command line against the invocation's working directory
+std::string resolve_path(const std::string& path, const std::string& working_dir);
+
+// Where a job's executable is written: its -o name, or the input's stem
+std::string executable_path(const CompileJob& job, const std::string& working_dir);
+
+// Compile all jobs on a worker pool; results are returned in job order
+std::vector<CompileResult> compile_files(const std::vector<CompileJob>& jobs, const DriverOptions& options);
+
+// A parsed risc command line
+struct Invocation {
+    std::vector<CompileJob> jobs;
+    DriverOptions options;
+    bool auto_run = false;
+    bool build_modules = false; // `risc build`: separate compilation of module units
+    bool start_server = false; // --server: serve compile requests on socket_path
+    bool use_server = false;   // --connect: forward this command line to the server
+    std::string socket_path;
+};
+
+// What an invocation produced, in the form both the CLI and the compile server report
+struct InvocationResult {
+    int exit_code = 0;
+    std::string log;
+    std::string errors;
+    std::vector<std::string> output_files; // One entry per job, empty if the job failed
+};
+
+// Parse risc's arguments (without argv[0]). Manifest paths are resolved against working_dir.
+bool parse_arguments(const std::vector<std::string>& args, const std::string& working_dir,
+                     Invocation& invocation, std::string& error);
+
+// Compile every job of an invocation and collect the output in job order
+InvocationResult run_invocation(const Invocation& invocation);
+
+// Read a batch manifest: one "<input.ris> [output]" per line, blank lines
+// and lines starting with '#' are ignored
+bool read_manifest(const std::string& path, std::vector<CompileJob>& jobs, std::string& error);
+
+} // namespace ris
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ast.h"
+#include <cstddef>
+
+namespace ris {
+
+// Find the list literals that can live in their function's stack frame. A
+// local list escapes when its value may be reached once the variable is gone:
+// returned, passed to a function, pushed into or stored in a list, or
+// assigned to another variable. Indexing it, calling its methods, passing it
+// to extend, print or println, comparing it with == or !=, and assigning to
+// it do not let it escape, except within a return statement, whose last
+// call may become a tail call.
+//
+// The literal initializing a local that never escapes is marked
+// stack_allocated; the code generator then keeps the list header, and with it
+// the first RIS_LIST_INLINE_CAPACITY elements, in an entry-block alloca.
+// Longer lists still move their slots to the heap as they grow.
+//
+// Locals are matched by name across the whole function, so a name that
+// escapes anywhere keeps every list declared under it on the heap. Runs on an
+// analyzed program; returns the number of literals marked.
+size_t mark_stack_lists(Program& program);
+
+} // namespace ris
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "token.h"
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,14 @@ public:
     
     // Check if std library is included
     bool includes_std() const { return includes_std_; }
+    
+    // Module mode: instead of splicing an included file's source, splice the text
+    // the reader returns for its resolved path (its interface). Returns false on failure.
+    using IncludeReader = std::function<bool(const std::string& path, std::string& content)>;
+    void set_include_reader(IncludeReader reader) { include_reader_ = std::move(reader); }
+    
+    // Resolved paths of every `#include "file"` seen, in source order
+    const std::vector<std::string>& included_files() const { return included_files_; }
 
 private:
     std::string source_;
@@ -41,6 +50,8 @@ private:
     bool has_error_;
     std::string error_message_;
     bool includes_std_;
+    IncludeReader include_reader_;
+    std::vector<std::string> included_files_;
     
     // Helper methods
     char current_char() const;
@@ -59,6 +70,7 @@ private:
     Token scan_preprocessor();
     
     // File inclusion
+    std::string include_path(const std::string& filename, const std::string& current_dir) const;
     std::string read_include_file(const std::string& filename, const std::string& current_dir);
     
     // Character classification
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ris {
+
+// How the final executable is linked
+struct LinkOptions {
+    bool static_link = false; // --static: no dynamic loader at startup
+    bool pie = true;          // --no-pie clears this: fixed load address, no startup relocations
+    bool verbose = false;
+};
+
+// Link objects (and the runtime library, unless empty) into an executable.
+// Built with RIS_WITH_LLD the link runs in-process through lld::elf::link;
+// otherwise, or when the host toolchain cannot be located, the clang++
+// driver is spawned instead. Either way the linker's diagnostics are
+// written to `errors`, never to the process's own stderr.
+bool link_executable(const std::vector<std::string>& object_files, const std::string& runtime_library,
+                     const std::string& output_file, const LinkOptions& options,
+                     std::ostream& log, std::ostream& errors);
+
+} // namespace ris
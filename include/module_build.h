@@ -0,0 +1,22 @@
+#pragma once
+
+#include "driver.h"
+#include <string>
+
+namespace ris {
+
+// `risc build`: compile a program as separate module units. Every .ris file
+// reached through `#include "file"` becomes its own object, and its exported
+// function signatures go to an interface file (<unit>.risi) that dependents
+// splice in instead of the source, along with the interfaces it includes in
+// turn, so includes are transitive as they are for a single-file build. A unit is recompiled only when its own
+// tokens or the interfaces it includes change, so editing a function body
+// rebuilds a single object. Alongside the executable a make-style depfile
+// (<output>.d) lists every source the program was built from, and
+// <output>.link records the link mode, so changing --static or --no-pie
+// relinks even when no object changed.
+//
+// Build products live in <working_dir>/out/modules.
+CompileResult build_program(const CompileJob& job, const DriverOptions& options);
+
+} // namespace ris
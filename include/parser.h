@@ -42,8 +42,10 @@ private:
     std::unique_ptr<Stmt> parse_statement();
     std::unique_ptr<BlockStmt> parse_block();
     std::unique_ptr<IfStmt> parse_if_statement();
-    std::unique_ptr<WhileStmt> parse_while_statement();
-    std::unique_ptr<ForStmt> parse_for_statement();
+    std::unique_ptr<Stmt> parse_annotated_statement();
+    std::vector<Annotation> parse_annotations();
+    std::unique_ptr<WhileStmt> parse_while_statement(std::vector<Annotation> annotations = {});
+    std::unique_ptr<ForStmt> parse_for_statement(std::vector<Annotation> annotations = {});
     std::unique_ptr<SwitchStmt> parse_switch_statement();
     std::unique_ptr<CaseStmt> parse_case_statement();
     std::unique_ptr<BreakStmt> parse_break_statement();
@@ -4,6 +4,8 @@
 #include "types.h"
 #include "symbol_table.h"
 #include "diagnostics.h"
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -24,13 +26,29 @@ public:
     // Get the diagnostic reporter
     DiagnosticReporter& get_diagnostics() { return diagnostics_; }
     const DiagnosticReporter& get_diagnostics() const { return diagnostics_; }
+    
+    // Number of threads used to check function bodies (0 = one per hardware thread)
+    void set_jobs(unsigned jobs) { jobs_ = jobs; }
 
 private:
+    // Worker analyzer: checks function bodies against a shared, read-only global scope
+    explicit SemanticAnalyzer(Scope* global_scope);
+    
     SymbolTable symbol_table_;
     bool has_error_;
     std::string error_message_;
     std::vector<std::string> errors_;
     DiagnosticReporter diagnostics_;
+    unsigned jobs_;
+    std::set<std::string> defined_functions_; // Functions that have a body (vs. prototypes)
+    std::map<std::string, std::set<std::string>> function_annotations_; // Union over each function's declarations
+    Scope* global_scope_; // Where global variables live (shared with the workers)
+    
+    // Effects of the body being checked, before those of its callees
+    FunctionPurity body_purity_;
+    bool body_may_not_return_; // Loops, allocates, or calls something that may not return
+    std::set<std::string> body_callees_;
+    std::string body_runtime_only_; // What keeps the body from running at compile time, if anything
     
     // Track current function for return statement analysis
     std::string current_function_name_;
@@ -51,13 +69,24 @@ private:
     
     // Program analysis
     void analyze_program(Program& program);
-    void analyze_function(FuncDecl& func);
+    bool declare_function(FuncDecl& func);
+    void analyze_function_body(FuncDecl& func);
+    void merge_results(const SemanticAnalyzer& worker);
+    void infer_function_effects(Program& program, const std::vector<std::unique_ptr<SemanticAnalyzer>>& workers);
+    void check_const_functions(const Program& program, const std::vector<std::unique_ptr<SemanticAnalyzer>>& workers);
+    void note_effect(FunctionPurity purity);
+    void note_runtime_only(const std::string& reason);
+    void note_allocation();
+    void note_variable_access(const std::string& name, bool write);
+    void check_assignment_target(Expr& target); // A variable or list element, noted as written
     void analyze_variable_declaration(VarDecl& var, bool is_global = false);
     void analyze_statement(Stmt& stmt);
     void analyze_block(BlockStmt& block);
     void analyze_if_statement(IfStmt& stmt);
     void analyze_while_statement(WhileStmt& stmt);
     void analyze_for_statement(ForStmt& stmt);
+    void check_loop_annotations(const std::vector<Annotation>& annotations);
+    void check_function_annotations(const FuncDecl& func);
     void analyze_switch_statement(SwitchStmt& stmt);
     void analyze_case_statement(CaseStmt& stmt);
     void analyze_break_statement(BreakStmt& stmt);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "driver.h"
+#include <string>
+#include <vector>
+
+namespace ris {
+
+// Socket the compile server listens on when --socket is not given:
+// $XDG_RUNTIME_DIR/risc.sock, or a private directory under /tmp
+std::string default_socket_path();
+
+// Serve compile requests on a Unix socket until the process is killed.
+// LLVM is initialized once for the lifetime of the server and requests are
+// handled concurrently on a worker pool. The socket's directory must belong
+// to the current user and be writable by nobody else, and only that user's
+// connections are served. Returns non-zero if the socket could not be set up.
+int run_server(const std::string& socket_path, bool verbose);
+
+// Forward a command line to a running server and wait for its result.
+// Returns false (leaving result untouched) if no server of the current user
+// is reachable.
+bool run_client(const std::string& socket_path, const std::vector<std::string>& args,
+                const std::string& working_dir, InvocationResult& result);
+
+} // namespace ris
@@ -19,12 +19,18 @@ typedef enum {
     TYPE_LIST = 5
 } type_tag_t;
 
-// List structure for runtime
+// Elements a list holds before its slots move to the heap
+#define RIS_LIST_INLINE_CAPACITY 4
+
+// List structure for runtime. A short list lives entirely in its header:
+// `data` points at inline_slots, and scalar elements at inline_cells
 typedef struct {
     void** data;        // Array of pointers to elements
     size_t size;        // Number of elements
     size_t capacity;    // Allocated capacity
     type_tag_t element_type; // Type of elements in the list
+    void* inline_slots[RIS_LIST_INLINE_CAPACITY];
+    int64_t inline_cells[RIS_LIST_INLINE_CAPACITY];
 } ris_list_t;
 
 // Print functions (like Python's print)
@@ -42,8 +48,27 @@ size_t ris_string_length(const char* str);
 
 // List functions
 ris_list_t* ris_list_create(type_tag_t element_type, size_t initial_capacity);
+// Set up a header the caller owns, such as a stack slot, as an empty list
+void ris_list_init(ris_list_t* list, type_tag_t element_type, size_t initial_capacity);
+// Copy `count` elements laid out as an array: int64_t or double for ints and
+// floats, int8_t for bools and chars, pointers for strings and lists
+ris_list_t* ris_list_from_array(type_tag_t element_type, const void* elements, size_t count);
+void ris_list_init_from_array(ris_list_t* list, type_tag_t element_type, const void* elements, size_t count);
 void ris_list_free(ris_list_t* list);
+
+// Bulk list operations. element_type is the list's static element type,
+// and `value` points to one element as laid out for ris_list_from_array
+void ris_list_reserve(ris_list_t* list, size_t capacity);
+void ris_list_resize(ris_list_t* list, size_t size, type_tag_t element_type, const void* value);
+void ris_list_fill(ris_list_t* list, type_tag_t element_type, const void* value);
+void ris_list_clear(ris_list_t* list);
+void ris_list_extend(ris_list_t* list, type_tag_t element_type, const ris_list_t* other);
+ris_list_t* ris_list_copy(const ris_list_t* list, type_tag_t element_type);
+int8_t ris_list_equal(const ris_list_t* a, const ris_list_t* b, type_tag_t element_type);
 void ris_list_push(ris_list_t* list, void* element);
+// Push one element laid out as for ris_list_from_array; scalars are copied
+// into a cell the list provides
+void ris_list_push_value(ris_list_t* list, type_tag_t element_type, const void* value);
 void* ris_list_pop(ris_list_t* list);
 size_t ris_list_size(ris_list_t* list);
 void* ris_list_get(ris_list_t* list, size_t index);
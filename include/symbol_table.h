@@ -108,6 +108,10 @@ class SymbolTable {
 public:
     SymbolTable();
     
+    // Start with a local scope chained to an external, read-only parent scope
+    // (used by worker analyzers that share the global scope between threads)
+    explicit SymbolTable(Scope* parent);
+    
     // Enter a new scope
     void enter_scope();
     
@@ -131,6 +135,9 @@ public:
     
     // Get current scope
     Scope* current_scope() { return scopes_.empty() ? nullptr : scopes_.back().get(); }
+    
+    // Get the outermost scope owned by this table
+    Scope* global_scope() { return scopes_.empty() ? nullptr : scopes_.front().get(); }
 
 private:
     std::vector<std::unique_ptr<Scope>> scopes_;
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "ast.h"
+#include <cstddef>
+
+namespace ris {
+
+// Turn self tail recursion into iteration. In a function f whose body
+// contains `return f(a, b)`, the body is wrapped in `while (true) { ... }`
+// and each such return becomes "evaluate a and b, assign them to the
+// parameters, continue". Deep recursion then runs in constant stack even
+// without optimization.
+//
+// Only returns outside any loop or switch are rewritten, so the `continue`
+// always reaches the new loop. Runs on an analyzed program; returns the
+// number of functions rewritten.
+size_t rewrite_tail_recursion(Program& program);
+
+} // namespace ris
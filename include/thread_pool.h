@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ris {
+
+// Fixed-size pool of worker threads shared by the parallel compiler phases
+class ThreadPool {
+public:
+    // Create a pool with the given number of workers (0 = one per hardware thread)
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task for execution on one of the workers
+    void submit(std::function<void()> task);
+
+    // Block until every queued task has finished
+    void wait();
+
+    // Number of worker threads
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Number of jobs to use when the user did not ask for a specific count
+    static unsigned default_jobs();
+
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable task_available_;
+    std::condition_variable all_done_;
+    size_t pending_;
+    bool stopping_;
+
+    void worker_loop();
+};
+
+// Run body(0) .. body(count - 1) on up to `jobs` threads (0 = default).
+// Runs inline when there is only one item or one job, so small inputs pay nothing.
+void parallel_for(size_t count, unsigned jobs, const std::function<void(size_t)>& body);
+
+} // namespace ris
@@ -20,17 +20,17 @@ enum class TokenType {
     // Keywords
     INT, FLOAT, BOOL, CHAR, STRING, VOID, LIST,
     IF, ELSE, WHILE, FOR, SWITCH, CASE, DEFAULT, BREAK, CONTINUE, RETURN,
-    TRUE, FALSE,
+    TRUE, FALSE, CONST,
     
     // Operators
     PLUS, MINUS, MULTIPLY, DIVIDE, MODULO,
     EQUAL, NOT_EQUAL, LESS, GREATER, LESS_EQUAL, GREATER_EQUAL,
     AND, OR, NOT,
-    ASSIGN,
+    ASSIGN, PLUS_ASSIGN, MINUS_ASSIGN, MULTIPLY_ASSIGN, DIVIDE_ASSIGN, MODULO_ASSIGN,
     INCREMENT,
     
     // Punctuation
-    SEMICOLON, COMMA, DOT, COLON,
+    SEMICOLON, COMMA, DOT, COLON, AT,
     LEFT_PAREN, RIGHT_PAREN,
     LEFT_BRACE, RIGHT_BRACE,
     LEFT_BRACKET, RIGHT_BRACKET,
@@ -78,4 +78,10 @@ struct Token {
 TokenType keyword_to_token_type(const std::string& keyword);
 std::string token_type_to_string(TokenType type);
 
+// `=` and the compound assignments `+=`, `-=`, `*=`, `/=`, `%=`
+bool is_assignment_operator(TokenType type);
+
+// The arithmetic a compound assignment applies (PLUS for `+=`), or ASSIGN for `=`
+TokenType compound_assignment_operator(TokenType type);
+
 } // namespace ris
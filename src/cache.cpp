@@ -0,0 +1,171 @@
+#include "cache.h"
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/SHA1.h>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace ris {
+
+void CacheKey::add_tokens(const std::vector<Token>& tokens) {
+    for (const auto& token : tokens) {
+        add(std::to_string(static_cast<int>(token.type)) + ":" + token.value);
+    }
+}
+
+void CacheKey::add_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+    add(contents);
+}
+
+void CacheKey::add(const std::string& field) {
+    // Length-prefix every field so that ("ab", "c") and ("a", "bc") differ
+    data_ += std::to_string(field.size());
+    data_ += ':';
+    data_ += field;
+}
+
+std::string CacheKey::digest() const {
+    auto hash = llvm::SHA1::hash(llvm::arrayRefFromStringRef(data_));
+    return llvm::toHex(llvm::ArrayRef<uint8_t>(hash.data(), hash.size()), /*LowerCase=*/true);
+}
+
+CompileCache::CompileCache(std::string directory, uintmax_t max_size)
+    : directory_(std::move(directory)), max_size_(max_size) {}
+
+std::string CompileCache::default_directory() {
+    if (const char* dir = std::getenv("RISC_CACHE_DIR")) {
+        return dir;
+    }
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
+        return (std::filesystem::path(xdg) / "risc").string();
+    }
+    if (const char* home = std::getenv("HOME")) {
+        return (std::filesystem::path(home) / ".cache" / "risc").string();
+    }
+    return "";
+}
+
+uintmax_t CompileCache::default_max_size() {
+    if (const char* size = std::getenv("RISC_CACHE_SIZE")) {
+        return std::strtoull(size, nullptr, 10) * 1024 * 1024;
+    }
+    return uintmax_t(256) * 1024 * 1024;
+}
+
+std::string CompileCache::compiler_version() {
+    std::string version = std::string("LLVM ") + LLVM_VERSION_STRING;
+
+    // Rebuilding risc must invalidate the cache, so fold in the identity of
+    // the running binary where the platform exposes it
+    std::error_code ec;
+    std::filesystem::path self = std::filesystem::read_symlink("/proc/self/exe", ec);
+    if (!ec) {
+        auto size = std::filesystem::file_size(self, ec);
+        auto modified = std::filesystem::last_write_time(self, ec);
+        if (!ec) {
+            version += " " + std::to_string(size) + " " + std::to_string(modified.time_since_epoch().count());
+            return version;
+        }
+    }
+
+    return version + " " + __DATE__ + " " + __TIME__;
+}
+
+bool CompileCache::fetch(const std::string& key, const std::string& destination) const {
+    if (directory_.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::path entry = std::filesystem::path(directory_) / key;
+    if (!std::filesystem::is_regular_file(entry, ec)) {
+        return false;
+    }
+
+    std::filesystem::copy_file(entry, destination, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) {
+        return false;
+    }
+
+    // The modification time doubles as the last use, which eviction goes by
+    std::filesystem::last_write_time(entry, std::filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void CompileCache::store(const std::string& key, const std::string& artifact) const {
+    if (directory_.empty()) {
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        return;
+    }
+
+    // Copy to a name private to this thread, then rename into place, so readers
+    // never see a half-written entry and racing writers simply replace each other
+    std::ostringstream temp_name;
+    temp_name << key << ".tmp." << getpid() << "." << std::this_thread::get_id();
+    std::filesystem::path temp = std::filesystem::path(directory_) / temp_name.str();
+
+    std::filesystem::copy_file(artifact, temp, std::filesystem::copy_options::overwrite_existing, ec);
+    if (!ec) {
+        std::filesystem::rename(temp, std::filesystem::path(directory_) / key, ec);
+    }
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return;
+    }
+
+    evict();
+}
+
+void CompileCache::evict() const {
+    struct Entry {
+        std::filesystem::path path;
+        std::filesystem::file_time_type used;
+        uintmax_t size;
+    };
+
+    // Another process may be storing or evicting at the same time; entries
+    // that vanish mid-scan are skipped, and in-flight copies are left alone
+    std::vector<Entry> entries;
+    uintmax_t total = 0;
+    std::error_code ec;
+    std::filesystem::directory_iterator it(directory_, ec), end;
+    for (; !ec && it != end; it.increment(ec)) {
+        std::error_code entry_ec;
+        if (!it->is_regular_file(entry_ec) || it->path().filename().string().find(".tmp.") != std::string::npos) {
+            continue;
+        }
+        Entry entry{it->path(), it->last_write_time(entry_ec), it->file_size(entry_ec)};
+        if (!entry_ec) {
+            total += entry.size;
+            entries.push_back(entry);
+        }
+    }
+    if (total <= max_size_) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const auto& entry : entries) {
+        if (total <= max_size_) {
+            break;
+        }
+        if (std::filesystem::remove(entry.path, ec)) {
+            total -= entry.size;
+        }
+    }
+}
+
+} // namespace ris
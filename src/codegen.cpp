@@ -1,28 +1,91 @@
 #include "codegen.h"
 #include "std.h"
+#include "thread_pool.h"
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/MC/MCSubtargetInfo.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+#if LLVM_VERSION_MAJOR >= 17
+#include <llvm/TargetParser/Host.h>
+#else
+#include <llvm/Support/Host.h>
+#endif
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <mutex>
 
 namespace ris {
 
-CodeGenerator::CodeGenerator() 
-    : has_error_(false), error_message_("") {
-    // Initialize LLVM
-    llvm::InitializeAllTargetInfos();
-    llvm::InitializeAllTargets();
-    llvm::InitializeAllTargetMCs();
-    llvm::InitializeAllAsmParsers();
-    llvm::InitializeAllAsmPrinters();
+namespace {
+
+// Runtime tag for a list's static element type
+type_tag_t element_tag(const std::string& type) {
+    if (type == "float") {
+        return TYPE_FLOAT;
+    } else if (type == "bool") {
+        return TYPE_BOOL;
+    } else if (type == "char") {
+        return TYPE_CHAR;
+    } else if (type == "string") {
+        return TYPE_STRING;
+    } else if (type.rfind("list<", 0) == 0) {
+        return TYPE_LIST;
+    }
+    return TYPE_INT;
+}
+
+} // namespace
+
+CodeGenerator::CodeGenerator(const CodeGenOptions& options) 
+    : options_(options), partition_index_(0), partition_count_(1),
+      has_error_(false), error_message_("") {
+    // Initialize LLVM (once per process, generators may be created on worker threads)
+    static std::once_flag llvm_initialized;
+    std::call_once(llvm_initialized, []() {
+        llvm::InitializeAllTargetInfos();
+        llvm::InitializeAllTargets();
+        llvm::InitializeAllTargetMCs();
+        llvm::InitializeAllAsmParsers();
+        llvm::InitializeAllAsmPrinters();
+    });
     
     context_ = std::make_unique<llvm::LLVMContext>();
+#if LLVM_VERSION_MAJOR < 15
+    // The generator emits opaque `ptr` types throughout
+    context_->enableOpaquePointers();
+#endif
     module_ = std::make_unique<llvm::Module>("ris_module", *context_);
     builder_ = std::make_unique<llvm::IRBuilder<>>(*context_);
+    
+    // Float arithmetic is strict IEEE unless relaxed on the command line; the
+    // builder stamps these flags on every floating-point instruction it creates
+    llvm::FastMathFlags fast_math;
+    if (options_.fast_math) {
+        fast_math.setFast();
+    }
+    if (options_.reassoc) {
+        fast_math.setAllowReassoc();
+    }
+    if (options_.fp_contract) {
+        fast_math.setAllowContract(true);
+    }
+    builder_->setFastMathFlags(fast_math);
+    
+    configure_target();
 }
 
 CodeGenerator::~CodeGenerator() = default;
@@ -30,29 +93,216 @@ CodeGenerator::~CodeGenerator() = default;
 bool CodeGenerator::generate(std::unique_ptr<Program> program, const std::string& output_file) {
     generate_program(*program);
     
-    if (has_error_) {
+    if (has_error_ || !verify_module()) {
         return false;
     }
     
-    // Verify the module
+    // Write LLVM IR to file
+    std::error_code ec;
+    llvm::raw_fd_ostream out(output_file, ec, llvm::sys::fs::OF_None);
+    if (ec) {
+        error("Failed to open output file: " + ec.message());
+        return false;
+    }
+    
+    module_->print(out, nullptr);
+    return true;
+}
+
+bool CodeGenerator::generate_objects(std::unique_ptr<Program> program, const std::string& output_prefix,
+                                     std::vector<std::string>& object_files) {
+    size_t partitions = std::max<size_t>(1, std::min<size_t>(options_.jobs, program->functions.size()));
+    
+    // One generator per partition, each with its own LLVMContext and Module.
+    // Functions owned by other partitions are only declared, globals live in partition 0.
+    std::vector<std::unique_ptr<CodeGenerator>> parts(partitions);
+    std::vector<bool> succeeded(partitions, false);
+    
+    parallel_for(partitions, options_.jobs, [&](size_t i) {
+        CodeGenerator* part = this;
+        if (partitions > 1) {
+            parts[i].reset(new CodeGenerator(options_));
+            part = parts[i].get();
+            part->partition_index_ = i;
+            part->partition_count_ = partitions;
+        }
+        
+        part->generate_program(*program);
+        if (part->has_error_ || !part->verify_module()) {
+            return;
+        }
+        part->optimize_module();
+        succeeded[i] = part->emit_object(output_prefix + "." + std::to_string(i) + ".o");
+    });
+    
+    // Collect results in partition order so errors are reported deterministically
+    for (size_t i = 0; i < partitions; ++i) {
+        if (parts[i] && parts[i]->has_error_) {
+            has_error_ = true;
+            if (error_message_.empty()) {
+                error_message_ = parts[i]->error_message_;
+            }
+            for (const auto& diag : parts[i]->diagnostics_.get_diagnostics()) {
+                diagnostics_.add_diagnostic(diag.severity, diag.message, diag.position, diag.component);
+            }
+        }
+        if (succeeded[i]) {
+            object_files.push_back(output_prefix + "." + std::to_string(i) + ".o");
+        }
+    }
+    
+    return !has_error_ && object_files.size() == partitions;
+}
+
+void CodeGenerator::resolve_target(const CodeGenOptions& options, std::string& cpu, std::string& features) {
+    cpu = options.target_cpu.empty() ? "generic" : options.target_cpu;
+    features.clear();
+    
+    if (cpu == "native") {
+        cpu = llvm::sys::getHostCPUName().str();
+        
+#if LLVM_VERSION_MAJOR >= 19
+        llvm::StringMap<bool> host_features = llvm::sys::getHostCPUFeatures();
+#else
+        llvm::StringMap<bool> host_features;
+        llvm::sys::getHostCPUFeatures(host_features);
+#endif
+        // StringMap iteration order is unspecified; sort so the string is stable
+        std::vector<std::string> sorted;
+        for (const auto& feature : host_features) {
+            sorted.push_back((feature.getValue() ? "+" : "-") + feature.getKey().str());
+        }
+        std::sort(sorted.begin(), sorted.end());
+        for (const auto& feature : sorted) {
+            features += (features.empty() ? "" : ",") + feature;
+        }
+    }
+    
+    // Explicit features come last so they override what the host reported
+    if (!options.target_features.empty()) {
+        features += (features.empty() ? "" : ",") + options.target_features;
+    }
+}
+
+std::string CodeGenerator::arithmetic_mode(const CodeGenOptions& options) {
+    std::string mode = "math";
+    mode += options.fast_math ? " fast" : "";
+    mode += options.fp_contract ? " contract" : "";
+    mode += options.reassoc ? " reassoc" : "";
+    mode += options.no_signed_wrap ? " nsw" : "";
+    return mode;
+}
+
+void CodeGenerator::configure_target() {
+    std::string triple = llvm::sys::getDefaultTargetTriple();
+    std::string lookup_error;
+    const llvm::Target* target = llvm::TargetRegistry::lookupTarget(triple, lookup_error);
+    if (!target) {
+        // Only fatal once native code is requested; textual IR does not need a target
+        return;
+    }
+    
+    resolve_target(options_, target_cpu_, target_features_);
+    
+    // Check the name up front; LLVM would only warn and fall back to a generic CPU
+    std::unique_ptr<llvm::MCSubtargetInfo> subtarget(target->createMCSubtargetInfo(triple, "", ""));
+    if (subtarget && !subtarget->isCPUStringValid(target_cpu_)) {
+        error("Unknown target CPU '" + target_cpu_ + "' for " + triple);
+        target_cpu_ = "generic";
+    }
+    
+    llvm::TargetOptions target_options;
+    target_options.AllowFPOpFusion = options_.fast_math || options_.fp_contract ? llvm::FPOpFusion::Fast
+                                                                                : llvm::FPOpFusion::Standard;
+    target_options.UnsafeFPMath = options_.fast_math;
+    target_options.NoInfsFPMath = options_.fast_math;
+    target_options.NoNaNsFPMath = options_.fast_math;
+    target_options.NoSignedZerosFPMath = options_.fast_math;
+    target_machine_.reset(target->createTargetMachine(
+        triple, target_cpu_, target_features_, target_options,
+        options_.pic ? llvm::Reloc::PIC_ : llvm::Reloc::Static));
+    
+    module_->setTargetTriple(triple);
+    module_->setDataLayout(target_machine_->createDataLayout());
+}
+
+bool CodeGenerator::verify_module() {
     std::string verification_error;
     llvm::raw_string_ostream error_stream(verification_error);
     if (llvm::verifyModule(*module_, &error_stream)) {
         // Parse the verification error to provide better diagnostics
-        std::string error_msg = parse_verification_error(verification_error);
+        std::string error_msg = parse_verification_error(error_stream.str());
         error(error_msg);
         return false;
     }
+    return true;
+}
+
+void CodeGenerator::optimize_module() {
+    if (options_.opt_level == 0) {
+        return;
+    }
+    
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+    
+    llvm::PassBuilder pass_builder(target_machine_.get());
+    pass_builder.registerModuleAnalyses(mam);
+    pass_builder.registerCGSCCAnalyses(cgam);
+    pass_builder.registerFunctionAnalyses(fam);
+    pass_builder.registerLoopAnalyses(lam);
+    pass_builder.crossRegisterProxies(lam, fam, cgam, mam);
+    
+    llvm::OptimizationLevel level = llvm::OptimizationLevel::O2;
+    if (options_.opt_level == 1) {
+        level = llvm::OptimizationLevel::O1;
+    } else if (options_.opt_level >= 3) {
+        level = llvm::OptimizationLevel::O3;
+    }
+    
+    llvm::ModulePassManager mpm;
+    if (whole_program()) {
+        // The same two stages as a full LTO link: the pre-link pipeline
+        // simplifies each function, then the LTO pipeline runs the
+        // interprocedural passes (GlobalDCE, IPSCCP, argument promotion,
+        // inlining, function attributes) that internal linkage unlocks
+        mpm = pass_builder.buildLTOPreLinkDefaultPipeline(level);
+        mpm.addPass(pass_builder.buildLTODefaultPipeline(level, nullptr));
+    } else {
+        mpm = pass_builder.buildPerModuleDefaultPipeline(level);
+    }
+    mpm.run(*module_, mam);
+}
+
+bool CodeGenerator::emit_object(const std::string& object_file) {
+    if (!target_machine_) {
+        error("No target available for " + llvm::sys::getDefaultTargetTriple());
+        return false;
+    }
     
-    // Write LLVM IR to file
     std::error_code ec;
-    llvm::raw_fd_ostream out(output_file, ec, llvm::sys::fs::OF_None);
+    llvm::raw_fd_ostream out(object_file, ec, llvm::sys::fs::OF_None);
     if (ec) {
-        error("Failed to open output file: " + ec.message());
+        error("Failed to open object file: " + ec.message());
         return false;
     }
     
-    module_->print(out, nullptr);
+#if LLVM_VERSION_MAJOR >= 18
+    auto file_type = llvm::CodeGenFileType::ObjectFile;
+#else
+    auto file_type = llvm::CGFT_ObjectFile;
+#endif
+    
+    llvm::legacy::PassManager pass_manager;
+    if (target_machine_->addPassesToEmitFile(pass_manager, out, nullptr, file_type)) {
+        error("Target cannot emit object files");
+        return false;
+    }
+    
+    pass_manager.run(*module_);
+    out.flush();
     return true;
 }
 
@@ -159,23 +409,117 @@ void CodeGenerator::generate_program(Program& program) {
     // Declare runtime functions
     declare_runtime_functions();
     
-    // Generate global variables
-    for (auto& global : program.globals) {
-        generate_variable_declaration(*global, true);
+    // Declare every function up front so calls resolve regardless of
+    // definition order or of which partition defines the callee
+    for (auto& func : program.functions) {
+        declare_function(*func);
+    }
+    
+    // Only main is reachable from outside a whole program, so every other
+    // defined function can be internal and use the fast calling convention;
+    // the optimizer may then inline, specialize or drop it freely
+    if (whole_program()) {
+        for (auto& func : program.functions) {
+            if (func->body && func->name != "main") {
+                llvm::Function* llvm_func = functions_[func->name];
+                llvm_func->setLinkage(llvm::GlobalValue::InternalLinkage);
+                llvm_func->setCallingConv(llvm::CallingConv::Fast);
+            }
+        }
     }
     
-    // Generate functions
-    for (auto& func : program.functions) {
-        generate_function(*func);
+    // Generate global variables
+    generate_global_initializers(program);
+    
+    // Generate the function bodies owned by this partition
+    for (size_t i = 0; i < program.functions.size(); ++i) {
+        if (owns_function(i) && program.functions[i]->body) {
+            generate_function(*program.functions[i]);
+        }
     }
     
     // Create main function if it doesn't exist
-    if (functions_.find("main") == functions_.end()) {
+    if (functions_.find("main") == functions_.end() && partition_index_ == 0 && !options_.module_unit) {
         create_main_function();
     }
 }
 
-void CodeGenerator::generate_function(FuncDecl& func) {
+void CodeGenerator::generate_global_initializers(Program& program) {
+    // Initializers are generated into a constructor that runs before main.
+    // Those that come out constant become the globals' static contents
+    // instead; anything fold_constants could not evaluate stays in the
+    // constructor, in declaration order.
+    llvm::FunctionType* init_type = llvm::FunctionType::get(llvm::Type::getVoidTy(*context_), false);
+    llvm::Function* init_func = llvm::Function::Create(init_type, llvm::Function::InternalLinkage,
+                                                       "ris.init_globals", module_.get());
+    llvm::BasicBlock* entry = llvm::BasicBlock::Create(*context_, "entry", init_func);
+    builder_->SetInsertPoint(entry);
+    
+    for (auto& global : program.globals) {
+        generate_variable_declaration(*global, true);
+    }
+    
+    if (init_func->size() == 1 && entry->empty()) {
+        init_func->eraseFromParent();
+    } else {
+        builder_->CreateRetVoid();
+        llvm::appendToGlobalCtors(*module_, init_func, 65535);
+    }
+    builder_->ClearInsertionPoint();
+}
+
+llvm::Constant* CodeGenerator::generate_constant_list(const std::string& name, ListLiteralExpr& expr) {
+    // Header, slot array and element cells all live in read-only data. The
+    // list is never written, so nothing ever reallocates or frees them.
+    llvm::Type* int_type = llvm::Type::getInt64Ty(*context_);
+    llvm::Type* ptr_type = llvm::PointerType::get(*context_, 0);
+    std::vector<llvm::Constant*> cells;
+    for (auto& element : expr.elements) {
+        auto* literal = dynamic_cast<LiteralExpr*>(element.get());
+        auto* cell = literal ? llvm::dyn_cast_or_null<llvm::ConstantInt>(generate_literal_expression(*literal)) : nullptr;
+        if (!cell || cell->getType() != int_type) {
+            return nullptr;
+        }
+        cells.push_back(cell);
+    }
+    
+    llvm::Constant* data = llvm::ConstantPointerNull::get(llvm::PointerType::get(*context_, 0));
+    if (!cells.empty()) {
+        auto* cells_type = llvm::ArrayType::get(int_type, cells.size());
+        auto* cell_array = new llvm::GlobalVariable(*module_, cells_type, true, llvm::GlobalValue::PrivateLinkage,
+                                                    llvm::ConstantArray::get(cells_type, cells), name + ".cells");
+        std::vector<llvm::Constant*> slots;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            llvm::Constant* indices[] = {llvm::ConstantInt::get(int_type, 0), llvm::ConstantInt::get(int_type, i)};
+            slots.push_back(llvm::ConstantExpr::getInBoundsGetElementPtr(cells_type, cell_array, indices));
+        }
+        auto* slots_type = llvm::ArrayType::get(ptr_type, slots.size());
+        data = new llvm::GlobalVariable(*module_, slots_type, true, llvm::GlobalValue::PrivateLinkage,
+                                        llvm::ConstantArray::get(slots_type, slots), name + ".slots");
+    }
+    
+    llvm::Constant* size = llvm::ConstantInt::get(int_type, cells.size());
+    llvm::StructType* list_type = list_header_type();
+    llvm::Constant* header = llvm::ConstantStruct::get(list_type,
+                                                       {data, size, size, llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), TYPE_INT),
+                                                        llvm::Constant::getNullValue(list_type->getElementType(4)),
+                                                        llvm::Constant::getNullValue(list_type->getElementType(5))});
+    return new llvm::GlobalVariable(*module_, list_header_type(), true, llvm::GlobalValue::PrivateLinkage, header,
+                                    name + ".list");
+}
+
+bool CodeGenerator::whole_program() const {
+    return options_.whole_program && partition_count_ == 1 && !options_.module_unit;
+}
+
+void CodeGenerator::declare_function(FuncDecl& func) {
+    // A prototype and the definition it announces share one llvm::Function,
+    // and either may carry the annotations
+    if (auto existing = functions_.find(func.name); existing != functions_.end()) {
+        set_function_hints(existing->second, func.annotations);
+        return;
+    }
+    
     // Get parameter types
     std::vector<llvm::Type*> param_types;
     for (const auto& param : func.parameters) {
@@ -196,18 +540,68 @@ void CodeGenerator::generate_function(FuncDecl& func) {
         module_.get()
     );
     
+    // RIS has no exceptions, and sema inferred what else a call can do
+    llvm_func->setDoesNotThrow();
+    if (func.purity == FunctionPurity::Pure) {
+        llvm_func->setDoesNotAccessMemory();
+    } else if (func.purity == FunctionPurity::ReadOnly) {
+        llvm_func->setOnlyReadsMemory();
+    }
+    if (func.always_returns) {
+        llvm_func->addFnAttr(llvm::Attribute::WillReturn);
+    }
+    set_function_hints(llvm_func, func.annotations);
+    
     functions_[func.name] = llvm_func;
+}
+
+void CodeGenerator::set_function_hints(llvm::Function* llvm_func, const std::vector<Annotation>& annotations) {
+    // Semantic analysis has rejected contradictory pairs
+    for (const auto& annotation : annotations) {
+        if (annotation.name == "inline") {
+            llvm_func->addFnAttr(llvm::Attribute::AlwaysInline);
+        } else if (annotation.name == "noinline") {
+            llvm_func->addFnAttr(llvm::Attribute::NoInline);
+        } else if (annotation.name == "hot") {
+            llvm_func->addFnAttr(llvm::Attribute::Hot);
+        } else if (annotation.name == "cold") {
+            // Calls to it are also treated as unlikely, so callers lay out those paths out of line
+            llvm_func->addFnAttr(llvm::Attribute::Cold);
+        }
+    }
+}
+
+void CodeGenerator::generate_function(FuncDecl& func) {
+    llvm::Function* llvm_func = functions_[func.name];
+    
+    // Per-function target attributes, as the optimizer's cost models read them
+    if (target_machine_) {
+        llvm_func->addFnAttr("target-cpu", target_cpu_);
+        if (!target_features_.empty()) {
+            llvm_func->addFnAttr("target-features", target_features_);
+        }
+    }
+    
+    // The backend resets its float options from these per function
+    if (options_.fast_math) {
+        for (const char* attribute : {"unsafe-fp-math", "no-infs-fp-math", "no-nans-fp-math", "no-signed-zeros-fp-math"}) {
+            llvm_func->addFnAttr(attribute, "true");
+        }
+    }
     
     // Create basic block for function body
     llvm::BasicBlock* entry_block = llvm::BasicBlock::Create(*context_, "entry", llvm_func);
     builder_->SetInsertPoint(entry_block);
     
-    // Add parameters to named values
+    // Parameters live in stack slots like locals, so they can be assigned;
+    // mem2reg turns them back into registers
     auto arg_it = llvm_func->arg_begin();
     for (size_t i = 0; i < func.parameters.size(); ++i) {
         if (arg_it != llvm_func->arg_end()) {
             arg_it->setName(func.parameters[i].second);
-            named_values_[func.parameters[i].second] = &*arg_it;
+            llvm::AllocaInst* slot = create_entry_alloca(arg_it->getType(), func.parameters[i].second);
+            set_tbaa(builder_->CreateStore(&*arg_it, slot), "ris variable");
+            named_values_[func.parameters[i].second] = slot;
             ++arg_it;
         }
     }
@@ -217,11 +611,39 @@ void CodeGenerator::generate_function(FuncDecl& func) {
         generate_block(*func.body);
     }
     
+    // @flatten: LLVM has no such function attribute, so every call made from
+    // the body is marked always-inline instead, as C compilers do
+    if (has_annotation(func.annotations, "flatten")) {
+        for (auto& block : *llvm_func) {
+            for (auto& inst : block) {
+                auto* call = llvm::dyn_cast<llvm::CallInst>(&inst);
+                llvm::Function* callee = call ? call->getCalledFunction() : nullptr;
+                if (callee && callee != llvm_func && !callee->isIntrinsic() && !call->isMustTailCall()) {
+                    call->addFnAttr(llvm::Attribute::AlwaysInline);
+                }
+            }
+        }
+    }
+    
     // Add return statement if function doesn't have one and return type is void
     // Only add if the current block doesn't already have a terminator
     if (func.return_type == "void" && !builder_->GetInsertBlock()->getTerminator()) {
         builder_->CreateRetVoid();
     }
+    
+    // The block after a loop nothing breaks out of cannot be reached
+    llvm::BasicBlock* last_block = builder_->GetInsertBlock();
+    if (!last_block->getTerminator() && last_block != &llvm_func->getEntryBlock() && llvm::pred_empty(last_block)) {
+        builder_->CreateUnreachable();
+    }
+}
+
+llvm::AllocaInst* CodeGenerator::create_entry_alloca(llvm::Type* type, const std::string& name) {
+    // Entry-block slots are allocated once per call, however often a loop
+    // body declares them, and are the ones mem2reg promotes
+    llvm::BasicBlock& entry = builder_->GetInsertBlock()->getParent()->getEntryBlock();
+    llvm::IRBuilder<> entry_builder(&entry, entry.begin());
+    return entry_builder.CreateAlloca(type, nullptr, name);
 }
 
 void CodeGenerator::generate_variable_declaration(VarDecl& var, bool is_global) {
@@ -230,10 +652,20 @@ void CodeGenerator::generate_variable_declaration(VarDecl& var, bool is_global)
     // Regular variable
     var_type = get_llvm_type(var.type);
     
+    if (is_global && partition_count_ > 1 && partition_index_ != 0) {
+        // Globals are defined by partition 0; other partitions reference them externally
+        module_->getOrInsertGlobal(var.name, var_type);
+        named_values_[var.name] = module_->getNamedGlobal(var.name);
+        return;
+    }
+    
     llvm::Value* initial_value = nullptr;
     
     // Generate initializer if present
-    if (var.initializer) {
+    if (var.initializer && is_global && var.constant_data) {
+        // A read-only table needs no code at all
+        initial_value = generate_constant_list(var.name, static_cast<ListLiteralExpr&>(*var.initializer));
+    } else if (var.initializer) {
         initial_value = generate_expression(*var.initializer);
     } else {
         // Create default initial value
@@ -257,16 +689,24 @@ void CodeGenerator::generate_variable_declaration(VarDecl& var, bool is_global)
         // Create global variable
         module_->getOrInsertGlobal(var.name, var_type);
         llvm::GlobalVariable* global_var = module_->getNamedGlobal(var.name);
-        global_var->setLinkage(llvm::GlobalValue::InternalLinkage);
+        // Partitioned modules share globals by name, so they must stay visible
+        global_var->setLinkage(partition_count_ > 1 ? llvm::GlobalValue::ExternalLinkage
+                                                    : llvm::GlobalValue::InternalLinkage);
         if (initial_value && llvm::isa<llvm::Constant>(initial_value)) {
             global_var->setInitializer(static_cast<llvm::Constant*>(initial_value));
+        } else {
+            // Computed at startup by the module constructor we are generating into
+            global_var->setInitializer(llvm::Constant::getNullValue(var_type));
+            if (initial_value) {
+                set_tbaa(builder_->CreateStore(initial_value, global_var), "ris variable");
+            }
         }
         named_values_[var.name] = global_var;
     } else {
         // Create local variable
-        llvm::AllocaInst* alloca = builder_->CreateAlloca(var_type, nullptr, var.name);
+        llvm::AllocaInst* alloca = create_entry_alloca(var_type, var.name);
         if (initial_value) {
-            builder_->CreateStore(initial_value, alloca);
+            set_tbaa(builder_->CreateStore(initial_value, alloca), "ris variable");
         }
         named_values_[var.name] = alloca;
     }
@@ -302,6 +742,10 @@ void CodeGenerator::generate_statement(Stmt& stmt) {
 
 void CodeGenerator::generate_block(BlockStmt& block) {
     for (auto& stmt : block.statements) {
+        // Code after a return, break or continue is unreachable
+        if (builder_->GetInsertBlock()->getTerminator()) {
+            break;
+        }
         generate_statement(*stmt);
     }
 }
@@ -379,7 +823,9 @@ llvm::Value* CodeGenerator::generate_identifier_expression(IdentifierExpr& expr)
         } else if (auto* global = llvm::dyn_cast<llvm::GlobalVariable>(var)) {
             element_type = global->getValueType();
         }
-        return builder_->CreateLoad(element_type, var, expr.name);
+        llvm::LoadInst* load = builder_->CreateLoad(element_type, var, expr.name);
+        set_tbaa(load, "ris variable");
+        return load;
     }
     
     // For function parameters, return the value directly
@@ -391,6 +837,17 @@ llvm::Value* CodeGenerator::generate_binary_expression(BinaryExpr& expr) {
         return nullptr;
     }
     
+    // Inside a function && and || skip their right side when the left decides;
+    // as a value the i1 result is widened to the i8 used to store a bool
+    if ((expr.op == TokenType::AND || expr.op == TokenType::OR) && builder_->GetInsertBlock()) {
+        llvm::Value* result = generate_logical_expression(expr);
+        return result ? builder_->CreateZExt(result, llvm::Type::getInt8Ty(*context_), "booltmp") : nullptr;
+    }
+    
+    if (is_assignment_operator(expr.op)) {
+        return generate_assignment(*expr.left, compound_assignment_operator(expr.op), expr.right.get(), false);
+    }
+    
     llvm::Value* left = generate_expression(*expr.left);
     llvm::Value* right = generate_expression(*expr.right);
     
@@ -398,25 +855,20 @@ llvm::Value* CodeGenerator::generate_binary_expression(BinaryExpr& expr) {
         return nullptr;
     }
     
-    switch (expr.op) {
-        case TokenType::ASSIGN: {
-            // Handle assignment: left must be an identifier
-            if (auto* identifier = dynamic_cast<IdentifierExpr*>(expr.left.get())) {
-                auto it = named_values_.find(identifier->name);
-                if (it == named_values_.end()) {
-                    error("Undefined variable: " + identifier->name);
-                    return nullptr;
-                }
-                
-                llvm::Value* var = it->second;
-                // Store the right value into the variable
-                builder_->CreateStore(right, var);
-                return right; // Return the assigned value
-            } else {
-                error("Left side of assignment must be a variable");
-                return nullptr;
-            }
-        }
+    // Lists compare element by element in the runtime
+    if (!expr.list_element_type.empty()) {
+        auto tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), element_tag(expr.list_element_type));
+        llvm::Value* equal = builder_->CreateCall(functions_["ris_list_equal"], {left, right, tag}, "list.equal");
+        llvm::Value* zero = llvm::ConstantInt::get(equal->getType(), 0);
+        return expr.op == TokenType::EQUAL ? builder_->CreateICmpNE(equal, zero, "eqtmp")
+                                           : builder_->CreateICmpEQ(equal, zero, "netmp");
+    }
+    
+    return generate_binary_operation(expr.op, left, right);
+}
+
+llvm::Value* CodeGenerator::generate_binary_operation(TokenType op, llvm::Value* left, llvm::Value* right) {
+    switch (op) {
         case TokenType::PLUS:
             // Check if this is string concatenation
             if (left->getType()->isPointerTy() && right->getType()->isPointerTy()) {
@@ -432,19 +884,19 @@ llvm::Value* CodeGenerator::generate_binary_expression(BinaryExpr& expr) {
             } else if (left->getType()->isFloatingPointTy()) {
                 return builder_->CreateFAdd(left, right, "addtmp");
             } else {
-                return builder_->CreateAdd(left, right, "addtmp");
+                return builder_->CreateAdd(left, right, "addtmp", false, options_.no_signed_wrap);
             }
         case TokenType::MINUS:
             if (left->getType()->isFloatingPointTy()) {
                 return builder_->CreateFSub(left, right, "subtmp");
             } else {
-                return builder_->CreateSub(left, right, "subtmp");
+                return builder_->CreateSub(left, right, "subtmp", false, options_.no_signed_wrap);
             }
         case TokenType::MULTIPLY:
             if (left->getType()->isFloatingPointTy()) {
                 return builder_->CreateFMul(left, right, "multmp");
             } else {
-                return builder_->CreateMul(left, right, "multmp");
+                return builder_->CreateMul(left, right, "multmp", false, options_.no_signed_wrap);
             }
         case TokenType::DIVIDE:
             if (left->getType()->isFloatingPointTy()) {
@@ -452,6 +904,12 @@ llvm::Value* CodeGenerator::generate_binary_expression(BinaryExpr& expr) {
             } else {
                 return builder_->CreateSDiv(left, right, "divtmp");
             }
+        case TokenType::MODULO:
+            if (left->getType()->isFloatingPointTy()) {
+                return builder_->CreateFRem(left, right, "remtmp");
+            } else {
+                return builder_->CreateSRem(left, right, "remtmp");
+            }
         case TokenType::EQUAL:
             if (left->getType()->isFloatingPointTy()) {
                 return builder_->CreateFCmpOEQ(left, right, "eqtmp");
@@ -489,6 +947,7 @@ llvm::Value* CodeGenerator::generate_binary_expression(BinaryExpr& expr) {
                 return builder_->CreateICmpNE(left, right, "netmp");
             }
         case TokenType::AND:
+            // Only constant initializers of globals get here
             return builder_->CreateAnd(left, right, "andtmp");
         case TokenType::OR:
             return builder_->CreateOr(left, right, "ortmp");
@@ -497,6 +956,113 @@ llvm::Value* CodeGenerator::generate_binary_expression(BinaryExpr& expr) {
     }
 }
 
+llvm::Value* CodeGenerator::generate_assignment(Expr& target, TokenType op, Expr* value, bool return_old) {
+    // `op` is ASSIGN for a plain store, otherwise the arithmetic applied to the
+    // old value; a missing `value` is the 1 that ++ adds
+    if (auto* identifier = dynamic_cast<IdentifierExpr*>(&target)) {
+        auto it = named_values_.find(identifier->name);
+        if (it == named_values_.end()) {
+            error("Undefined variable: " + identifier->name);
+            return nullptr;
+        }
+        
+        llvm::Value* old_value = op != TokenType::ASSIGN ? generate_identifier_expression(*identifier) : nullptr;
+        llvm::Value* operand = value ? generate_expression(*value) : llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), 1);
+        if ((op != TokenType::ASSIGN && !old_value) || !operand) {
+            return nullptr;
+        }
+        
+        llvm::Value* new_value = op == TokenType::ASSIGN ? operand : generate_binary_operation(op, old_value, operand);
+        if (!new_value) {
+            return nullptr;
+        }
+        set_tbaa(builder_->CreateStore(new_value, it->second), "ris variable");
+        return return_old ? old_value : new_value;
+    }
+    
+    if (auto* element = dynamic_cast<ListIndexExpr*>(&target)) {
+        llvm::Value* list = generate_list_operand(*element->list);
+        llvm::Value* index = generate_expression(*element->index);
+        llvm::Value* operand = value ? generate_expression(*value) : llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), 1);
+        if (!list || !index || !operand) {
+            return nullptr;
+        }
+        if (!index->getType()->isIntegerTy()) {
+            error("List index must be an integer");
+            return nullptr;
+        }
+        index = builder_->CreateSExtOrTrunc(index, llvm::Type::getInt64Ty(*context_));
+        // The cell holds the list's element type, whatever the right side is
+        if (!element->element_type.empty()) {
+            operand = convert_value(operand, get_llvm_type(element->element_type));
+        }
+        return generate_list_store(list, index, op, operand, return_old);
+    }
+    
+    error("Left side of assignment must be a variable or list element");
+    return nullptr;
+}
+
+llvm::Value* CodeGenerator::generate_logical_expression(BinaryExpr& expr) {
+    bool is_and = expr.op == TokenType::AND;
+    llvm::Value* left = generate_condition(*expr.left, is_and ? "and.lhs" : "or.lhs");
+    if (!left) {
+        return nullptr;
+    }
+    
+    llvm::Function* func = builder_->GetInsertBlock()->getParent();
+    llvm::BasicBlock* left_block = builder_->GetInsertBlock();
+    llvm::BasicBlock* right_block = llvm::BasicBlock::Create(*context_, is_and ? "and.rhs" : "or.rhs", func);
+    llvm::BasicBlock* end_block = llvm::BasicBlock::Create(*context_, is_and ? "and.end" : "or.end", func);
+    
+    // && needs its right side only when the left is true, || only when it is false
+    if (is_and) {
+        builder_->CreateCondBr(left, right_block, end_block);
+    } else {
+        builder_->CreateCondBr(left, end_block, right_block);
+    }
+    
+    builder_->SetInsertPoint(right_block);
+    llvm::Value* right = generate_condition(*expr.right, is_and ? "and.rhs" : "or.rhs");
+    if (!right) {
+        return nullptr;
+    }
+    // The right side may have branched itself; the PHI needs the block it ended in
+    llvm::BasicBlock* right_end = builder_->GetInsertBlock();
+    builder_->CreateBr(end_block);
+    
+    builder_->SetInsertPoint(end_block);
+    llvm::PHINode* result = builder_->CreatePHI(llvm::Type::getInt1Ty(*context_), 2, is_and ? "andtmp" : "ortmp");
+    result->addIncoming(llvm::ConstantInt::get(llvm::Type::getInt1Ty(*context_), is_and ? 0 : 1), left_block);
+    result->addIncoming(right, right_end);
+    return result;
+}
+
+llvm::Value* CodeGenerator::generate_condition(Expr& expr, const std::string& name) {
+    // likely(c) / unlikely(c): the condition, annotated with the value it usually has;
+    // the optimizer turns this into branch weights and lays the rare side out of line
+    auto* call = dynamic_cast<CallExpr*>(&expr);
+    if (call && (call->function_name == "likely" || call->function_name == "unlikely") && call->arguments.size() == 1) {
+        llvm::Value* value = generate_condition(*call->arguments[0], name);
+        if (!value || !builder_->GetInsertBlock()) {
+            return value;
+        }
+        llvm::Value* expected = llvm::ConstantInt::get(value->getType(), call->function_name == "likely");
+        return builder_->CreateIntrinsic(llvm::Intrinsic::expect, {value->getType()}, {value, expected}, nullptr, name);
+    }
+    
+    auto* binary = dynamic_cast<BinaryExpr*>(&expr);
+    if (binary && (binary->op == TokenType::AND || binary->op == TokenType::OR)) {
+        return generate_logical_expression(*binary);
+    }
+    
+    llvm::Value* value = generate_expression(expr);
+    if (value && !value->getType()->isIntegerTy(1)) {
+        value = builder_->CreateICmpNE(value, llvm::ConstantInt::get(value->getType(), 0), name);
+    }
+    return value;
+}
+
 llvm::Value* CodeGenerator::generate_unary_expression(UnaryExpr& expr) {
     if (!expr.operand) {
         return nullptr;
@@ -514,7 +1080,7 @@ llvm::Value* CodeGenerator::generate_unary_expression(UnaryExpr& expr) {
             if (operand->getType()->isFloatingPointTy()) {
                 return builder_->CreateFNeg(operand, "negtmp");
             } else {
-                return builder_->CreateNeg(operand, "negtmp");
+                return builder_->CreateNeg(operand, "negtmp", false, options_.no_signed_wrap);
             }
         default:
             return nullptr;
@@ -527,6 +1093,12 @@ llvm::Value* CodeGenerator::generate_call_expression(CallExpr& expr) {
         return generate_generic_print_call(expr);
     }
     
+    // A branch hint used as a value is the bool it wraps
+    if (expr.function_name == "likely" || expr.function_name == "unlikely") {
+        llvm::Value* result = generate_condition(expr, "expect");
+        return result ? builder_->CreateZExt(result, llvm::Type::getInt8Ty(*context_), "booltmp") : nullptr;
+    }
+    
     auto it = functions_.find(expr.function_name);
     if (it == functions_.end()) {
         error("Undefined function: " + expr.function_name);
@@ -541,7 +1113,220 @@ llvm::Value* CodeGenerator::generate_call_expression(CallExpr& expr) {
         args.push_back(generate_expression(*arg));
     }
     
-    return builder_->CreateCall(func, args);
+    // Calls must use the callee's convention (fastcc for internal functions)
+    llvm::CallInst* call = builder_->CreateCall(func, args);
+    call->setCallingConv(func->getCallingConv());
+    return call;
+}
+
+void CodeGenerator::mark_tail_call(llvm::Value* ret_value) {
+    // `return f(...)`: the call is the last thing before the return. A tail
+    // call promises the callee does not use the caller's frame, so none of
+    // its arguments may point there. mark_stack_lists keeps lists named in a
+    // return on the heap; element values passed by address are checked here.
+    auto* call = llvm::dyn_cast<llvm::CallInst>(ret_value);
+    if (!call || call->getParent() != builder_->GetInsertBlock() || call != &builder_->GetInsertBlock()->back()) {
+        return;
+    }
+    for (llvm::Value* arg : call->args()) {
+        if (llvm::isa<llvm::AllocaInst>(llvm::getUnderlyingObject(arg))) {
+            return;
+        }
+    }
+    llvm::Function* callee = call->getCalledFunction();
+    llvm::Function* caller = builder_->GetInsertBlock()->getParent();
+    if (!callee) {
+        return;
+    }
+    
+    // With identical signatures and conventions the jump is guaranteed, even
+    // unoptimized, so self and mutual recursion run in constant stack
+    if (callee->getFunctionType() == caller->getFunctionType() &&
+        callee->getCallingConv() == caller->getCallingConv()) {
+        call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+    } else {
+        call->setTailCallKind(llvm::CallInst::TCK_Tail);
+    }
+}
+
+void CodeGenerator::set_tbaa(llvm::Value* access, const std::string& type_name) {
+    // RIS cannot take the address of a variable or reinterpret memory, so
+    // every access is tagged with the one kind of storage it can touch
+    auto* inst = llvm::dyn_cast_or_null<llvm::Instruction>(access);
+    if (!inst) {
+        return;
+    }
+    llvm::MDBuilder md(*context_);
+    llvm::MDNode* root = md.createTBAARoot("ris TBAA");
+    llvm::MDNode* type = md.createTBAAScalarTypeNode(type_name, root);
+    inst->setMetadata(llvm::LLVMContext::MD_tbaa, md.createTBAAStructTagNode(type, type, 0));
+}
+
+std::string CodeGenerator::element_tbaa_type(llvm::Type* type) const {
+    // Keyed on the stored LLVM type, not the guessed list type, so a cell is
+    // always read with the tag it was written with
+    if (type->isIntegerTy(64)) {
+        return "ris int element";
+    }
+    if (type->isDoubleTy()) {
+        return "ris float element";
+    }
+    if (type->isIntegerTy(8)) {
+        return "ris byte element";
+    }
+    return "ris pointer element";
+}
+
+llvm::StructType* CodeGenerator::list_header_type() {
+    // {data, size, capacity, element_type, inline_slots, inline_cells}, as in std.h
+    llvm::StructType* list_type = llvm::StructType::getTypeByName(*context_, "ris_list_t");
+    if (!list_type) {
+        llvm::Type* ptr_type = llvm::PointerType::get(*context_, 0);
+        llvm::Type* size_type = llvm::Type::getInt64Ty(*context_);
+        list_type = llvm::StructType::create(*context_, {ptr_type, size_type, size_type, llvm::Type::getInt32Ty(*context_),
+                                                         llvm::ArrayType::get(ptr_type, RIS_LIST_INLINE_CAPACITY),
+                                                         llvm::ArrayType::get(size_type, RIS_LIST_INLINE_CAPACITY)},
+                                             "ris_list_t");
+    }
+    return list_type;
+}
+
+llvm::Value* CodeGenerator::generate_list_get(llvm::Value* list, llvm::Value* index, int element_tag, llvm::Function* getter) {
+    if (!builder_->GetInsertBlock() || !list->getType()->isPointerTy() || !index->getType()->isIntegerTy(64)) {
+        return builder_->CreateCall(getter, {list, index});
+    }
+    
+    // Mirrors the runtime getter
+    llvm::StructType* list_type = list_header_type();
+    llvm::Type* result_type = getter->getReturnType();
+    llvm::Constant* fallback = llvm::Constant::getNullValue(result_type);
+    
+    llvm::Function* func = builder_->GetInsertBlock()->getParent();
+    llvm::BasicBlock* check_block = llvm::BasicBlock::Create(*context_, "list.check", func);
+    llvm::BasicBlock* load_block = llvm::BasicBlock::Create(*context_, "list.load", func);
+    llvm::BasicBlock* end_block = llvm::BasicBlock::Create(*context_, "list.end", func);
+    
+    llvm::BasicBlock* null_block = builder_->GetInsertBlock();
+    builder_->CreateCondBr(builder_->CreateIsNotNull(list), check_block, end_block);
+    
+    builder_->SetInsertPoint(check_block);
+    llvm::LoadInst* size = builder_->CreateLoad(llvm::Type::getInt64Ty(*context_),
+                                                builder_->CreateStructGEP(list_type, list, 1), "list.size");
+    set_tbaa(size, "ris list header");
+    llvm::Value* in_range = builder_->CreateICmpULT(index, size, "list.inrange");
+    if (element_tag != TYPE_LIST) {
+        llvm::LoadInst* tag = builder_->CreateLoad(llvm::Type::getInt32Ty(*context_),
+                                                   builder_->CreateStructGEP(list_type, list, 3), "list.tag");
+        set_tbaa(tag, "ris list header");
+        llvm::Value* tag_ok = builder_->CreateICmpEQ(tag, llvm::ConstantInt::get(tag->getType(), element_tag));
+        in_range = builder_->CreateAnd(in_range, tag_ok, "list.ok");
+    }
+    builder_->CreateCondBr(in_range, load_block, end_block);
+    
+    builder_->SetInsertPoint(load_block);
+    llvm::Type* ptr_type = llvm::PointerType::get(*context_, 0);
+    llvm::LoadInst* data = builder_->CreateLoad(ptr_type, builder_->CreateStructGEP(list_type, list, 0), "list.data");
+    set_tbaa(data, "ris list header");
+    llvm::LoadInst* slot = builder_->CreateLoad(ptr_type, builder_->CreateInBoundsGEP(ptr_type, data, index), "list.slot");
+    set_tbaa(slot, "ris list slots");
+    
+    // Strings and nested lists are stored in the slot itself, scalars in a cell it points to
+    llvm::Value* value = slot;
+    if (element_tag != TYPE_STRING && element_tag != TYPE_LIST) {
+        llvm::LoadInst* element = builder_->CreateLoad(result_type, slot, "list.elem");
+        set_tbaa(element, element_tbaa_type(result_type));
+        value = element;
+    }
+    builder_->CreateBr(end_block);
+    
+    builder_->SetInsertPoint(end_block);
+    llvm::PHINode* result = builder_->CreatePHI(result_type, 3, "list.get");
+    result->addIncoming(fallback, null_block);
+    result->addIncoming(fallback, check_block);
+    result->addIncoming(value, load_block);
+    return result;
+}
+
+llvm::Value* CodeGenerator::convert_value(llvm::Value* value, llvm::Type* type) {
+    llvm::Type* from = value->getType();
+    if (from == type) {
+        return value;
+    }
+    if (from->isIntegerTy() && type->isDoubleTy()) {
+        return builder_->CreateSIToFP(value, type, "conv");
+    }
+    if (from->isDoubleTy() && type->isIntegerTy()) {
+        return builder_->CreateFPToSI(value, type, "conv");
+    }
+    if (from->isIntegerTy(1) && type->isIntegerTy()) {
+        return builder_->CreateZExt(value, type, "conv");
+    }
+    if (from->isIntegerTy() && type->isIntegerTy()) {
+        return builder_->CreateSExtOrTrunc(value, type, "conv");
+    }
+    return value;
+}
+
+llvm::Value* CodeGenerator::generate_list_store(llvm::Value* list, llvm::Value* index, TokenType op, llvm::Value* operand,
+                                               bool return_old) {
+    // Same checks as generate_list_get; a store out of range is dropped, and
+    // reads back as 0 like an out-of-range read
+    llvm::StructType* list_type = list_header_type();
+    llvm::Type* element_type = operand->getType();
+    llvm::Type* ptr_type = llvm::PointerType::get(*context_, 0);
+    
+    llvm::Function* func = builder_->GetInsertBlock()->getParent();
+    llvm::BasicBlock* check_block = llvm::BasicBlock::Create(*context_, "list.check", func);
+    llvm::BasicBlock* store_block = llvm::BasicBlock::Create(*context_, "list.store", func);
+    llvm::BasicBlock* end_block = llvm::BasicBlock::Create(*context_, "list.end", func);
+    
+    llvm::BasicBlock* null_block = builder_->GetInsertBlock();
+    builder_->CreateCondBr(builder_->CreateIsNotNull(list), check_block, end_block);
+    
+    builder_->SetInsertPoint(check_block);
+    llvm::LoadInst* size = builder_->CreateLoad(llvm::Type::getInt64Ty(*context_),
+                                                builder_->CreateStructGEP(list_type, list, 1), "list.size");
+    set_tbaa(size, "ris list header");
+    builder_->CreateCondBr(builder_->CreateICmpULT(index, size, "list.inrange"), store_block, end_block);
+    
+    // Strings and nested lists are stored in the slot itself, scalars in the cell it points to
+    builder_->SetInsertPoint(store_block);
+    llvm::LoadInst* data = builder_->CreateLoad(ptr_type, builder_->CreateStructGEP(list_type, list, 0), "list.data");
+    set_tbaa(data, "ris list header");
+    llvm::Value* address = builder_->CreateInBoundsGEP(ptr_type, data, index, "list.slotptr");
+    std::string tbaa_type = "ris list slots";
+    if (!element_type->isPointerTy()) {
+        llvm::LoadInst* cell = builder_->CreateLoad(ptr_type, address, "list.slot");
+        set_tbaa(cell, tbaa_type);
+        address = cell;
+        tbaa_type = element_tbaa_type(element_type);
+    }
+    
+    llvm::Value* old_value = nullptr;
+    llvm::Value* new_value = operand;
+    if (op != TokenType::ASSIGN) {
+        llvm::LoadInst* load = builder_->CreateLoad(element_type, address, "list.old");
+        set_tbaa(load, tbaa_type);
+        old_value = load;
+        new_value = generate_binary_operation(op, old_value, operand);
+        if (!new_value) {
+            return nullptr;
+        }
+    }
+    set_tbaa(builder_->CreateStore(new_value, address), tbaa_type);
+    llvm::BasicBlock* stored_block = builder_->GetInsertBlock();
+    builder_->CreateBr(end_block);
+    
+    builder_->SetInsertPoint(end_block);
+    if (op == TokenType::ASSIGN) {
+        return operand;
+    }
+    llvm::Constant* fallback = llvm::Constant::getNullValue(element_type);
+    llvm::PHINode* result = builder_->CreatePHI(element_type, 3, "list.update");
+    result->addIncoming(fallback, null_block);
+    result->addIncoming(fallback, check_block);
+    result->addIncoming(return_old ? old_value : new_value, stored_block);
+    return result;
 }
 
 llvm::Value* CodeGenerator::generate_generic_print_call(CallExpr& expr) {
@@ -590,27 +1375,27 @@ llvm::Value* CodeGenerator::generate_generic_print_call(CallExpr& expr) {
                 case TokenType::INTEGER_LITERAL:
                     type_tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), 0); // TYPE_INT
                     // Allocate space for the int value
-                    value_ptr = builder_->CreateAlloca(llvm::Type::getInt64Ty(*context_));
-                    builder_->CreateStore(arg_value, value_ptr);
+                    value_ptr = create_entry_alloca(llvm::Type::getInt64Ty(*context_));
+                    set_tbaa(builder_->CreateStore(arg_value, value_ptr), "ris variable");
                     break;
                 case TokenType::FLOAT_LITERAL:
                     type_tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), 1); // TYPE_FLOAT
                     // Allocate space for the float value
-                    value_ptr = builder_->CreateAlloca(llvm::Type::getDoubleTy(*context_));
-                    builder_->CreateStore(arg_value, value_ptr);
+                    value_ptr = create_entry_alloca(llvm::Type::getDoubleTy(*context_));
+                    set_tbaa(builder_->CreateStore(arg_value, value_ptr), "ris variable");
                     break;
                 case TokenType::TRUE:
                 case TokenType::FALSE:
                     type_tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), 2); // TYPE_BOOL
                     // Allocate space for the bool value
-                    value_ptr = builder_->CreateAlloca(llvm::Type::getInt8Ty(*context_));
-                    builder_->CreateStore(arg_value, value_ptr);
+                    value_ptr = create_entry_alloca(llvm::Type::getInt8Ty(*context_));
+                    set_tbaa(builder_->CreateStore(arg_value, value_ptr), "ris variable");
                     break;
                 case TokenType::CHAR_LITERAL:
                     type_tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), 3); // TYPE_CHAR
                     // Allocate space for the char value
-                    value_ptr = builder_->CreateAlloca(llvm::Type::getInt8Ty(*context_));
-                    builder_->CreateStore(arg_value, value_ptr);
+                    value_ptr = create_entry_alloca(llvm::Type::getInt8Ty(*context_));
+                    set_tbaa(builder_->CreateStore(arg_value, value_ptr), "ris variable");
                     break;
                 case TokenType::STRING_LITERAL:
                     type_tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), 4); // TYPE_STRING
@@ -625,13 +1410,13 @@ llvm::Value* CodeGenerator::generate_generic_print_call(CallExpr& expr) {
             if (arg_value->getType()->isIntegerTy(64)) {
                 // int type
                 type_tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), 0); // TYPE_INT
-                value_ptr = builder_->CreateAlloca(llvm::Type::getInt64Ty(*context_));
-                builder_->CreateStore(arg_value, value_ptr);
+                value_ptr = create_entry_alloca(llvm::Type::getInt64Ty(*context_));
+                set_tbaa(builder_->CreateStore(arg_value, value_ptr), "ris variable");
             } else if (arg_value->getType()->isDoubleTy()) {
                 // float type
                 type_tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), 1); // TYPE_FLOAT
-                value_ptr = builder_->CreateAlloca(llvm::Type::getDoubleTy(*context_));
-                builder_->CreateStore(arg_value, value_ptr);
+                value_ptr = create_entry_alloca(llvm::Type::getDoubleTy(*context_));
+                set_tbaa(builder_->CreateStore(arg_value, value_ptr), "ris variable");
             } else if (arg_value->getType()->isIntegerTy(8)) {
                 // bool or char type - need to determine which
                 if (auto* literal = dynamic_cast<LiteralExpr*>(arg_expr.get())) {
@@ -646,8 +1431,8 @@ llvm::Value* CodeGenerator::generate_generic_print_call(CallExpr& expr) {
                     // For non-literal expressions, assume char if it's i8
                     type_tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), 3); // TYPE_CHAR
                 }
-                value_ptr = builder_->CreateAlloca(llvm::Type::getInt8Ty(*context_));
-                builder_->CreateStore(arg_value, value_ptr);
+                value_ptr = create_entry_alloca(llvm::Type::getInt8Ty(*context_));
+                set_tbaa(builder_->CreateStore(arg_value, value_ptr), "ris variable");
             } else if (arg_value->getType()->isPointerTy()) {
                 // Check if this is a list type by looking at the expression
                 if (dynamic_cast<ListLiteralExpr*>(arg_expr.get())) {
@@ -695,8 +1480,8 @@ llvm::Value* CodeGenerator::generate_generic_print_call(CallExpr& expr) {
         }
     }
     
-    // Return void for print functions
-    return llvm::Constant::getNullValue(llvm::Type::getVoidTy(*context_));
+    // print functions produce no value
+    return nullptr;
 }
 
 
@@ -714,18 +1499,12 @@ void CodeGenerator::generate_if_statement(IfStmt& stmt) {
     }
     
     // Generate condition
-    llvm::Value* cond_value = generate_expression(*stmt.condition);
+    llvm::Value* cond_value = generate_condition(*stmt.condition, "ifcond");
     if (!cond_value) {
         error("Failed to generate if condition");
         return;
     }
     
-    // Convert condition to boolean if needed
-    if (!cond_value->getType()->isIntegerTy(1)) {
-        cond_value = builder_->CreateICmpNE(cond_value, 
-            llvm::ConstantInt::get(cond_value->getType(), 0), "ifcond");
-    }
-    
     // Get current function and create basic blocks
     llvm::Function* func = builder_->GetInsertBlock()->getParent();
     llvm::BasicBlock* then_block = llvm::BasicBlock::Create(*context_, "then", func);
@@ -820,26 +1599,24 @@ void CodeGenerator::generate_while_statement(WhileStmt& stmt) {
     control_flow_stack_.push_back({end_block, cond_block});
     
     // Branch to condition block
-    builder_->CreateBr(cond_block);
+    llvm::Instruction* entry_branch = builder_->CreateBr(cond_block);
     
     // Generate condition block
     builder_->SetInsertPoint(cond_block);
-    llvm::Value* cond_value = generate_expression(*stmt.condition);
+    llvm::Value* cond_value = generate_condition(*stmt.condition, "whilecond");
     if (!cond_value) {
         error("Failed to generate while condition");
         control_flow_stack_.pop_back();
         return;
     }
     
-    // Convert condition to boolean if needed
-    if (!cond_value->getType()->isIntegerTy(1)) {
-        cond_value = builder_->CreateICmpNE(cond_value, 
-            llvm::ConstantInt::get(cond_value->getType(), 0), "whilecond");
+    // Create conditional branch; `while (true)` is only left through break or return
+    if (auto* constant = llvm::dyn_cast<llvm::ConstantInt>(cond_value); constant && constant->isOne()) {
+        builder_->CreateBr(body_block);
+    } else {
+        builder_->CreateCondBr(cond_value, body_block, end_block);
     }
     
-    // Create conditional branch
-    builder_->CreateCondBr(cond_value, body_block, end_block);
-    
     // Generate body block
     builder_->SetInsertPoint(body_block);
     if (stmt.body) {
@@ -849,6 +1626,7 @@ void CodeGenerator::generate_while_statement(WhileStmt& stmt) {
     if (!builder_->GetInsertBlock()->getTerminator()) {
         builder_->CreateBr(cond_block);
     }
+    set_loop_hints(cond_block, entry_branch, stmt.annotations);
     
     // Pop control flow context
     control_flow_stack_.pop_back();
@@ -875,24 +1653,18 @@ void CodeGenerator::generate_for_statement(ForStmt& stmt) {
     if (stmt.init) {
         generate_statement(*stmt.init);
     }
-    builder_->CreateBr(cond_block);
+    llvm::Instruction* entry_branch = builder_->CreateBr(cond_block);
     
     // Generate condition block
     builder_->SetInsertPoint(cond_block);
     if (stmt.condition) {
-        llvm::Value* cond_value = generate_expression(*stmt.condition);
+        llvm::Value* cond_value = generate_condition(*stmt.condition, "forcond");
         if (!cond_value) {
             error("Failed to generate for condition");
             control_flow_stack_.pop_back();
             return;
         }
         
-        // Convert condition to boolean if needed
-        if (!cond_value->getType()->isIntegerTy(1)) {
-            cond_value = builder_->CreateICmpNE(cond_value, 
-                llvm::ConstantInt::get(cond_value->getType(), 0), "forcond");
-        }
-        
         // Create conditional branch
         builder_->CreateCondBr(cond_value, body_block, end_block);
     } else {
@@ -917,6 +1689,7 @@ void CodeGenerator::generate_for_statement(ForStmt& stmt) {
     }
     // Branch back to condition
     builder_->CreateBr(cond_block);
+    set_loop_hints(cond_block, entry_branch, stmt.annotations);
     
     // Pop control flow context
     control_flow_stack_.pop_back();
@@ -925,6 +1698,60 @@ void CodeGenerator::generate_for_statement(ForStmt& stmt) {
     builder_->SetInsertPoint(end_block);
 }
 
+void CodeGenerator::set_loop_hints(llvm::BasicBlock* header, llvm::Instruction* entry_branch,
+                                   const std::vector<Annotation>& annotations) {
+    if (annotations.empty()) {
+        return;
+    }
+    
+    // Semantic analysis has checked names and arguments
+    auto hint = [this](const char* name, llvm::Constant* value = nullptr) -> llvm::Metadata* {
+        std::vector<llvm::Metadata*> operands = {llvm::MDString::get(*context_, name)};
+        if (value) {
+            operands.push_back(llvm::ConstantAsMetadata::get(value));
+        }
+        return llvm::MDNode::get(*context_, operands);
+    };
+    auto count = [this](const std::string& value) {
+        return llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), std::stoul(value));
+    };
+    auto flag = [this](bool value) {
+        return llvm::ConstantInt::get(llvm::Type::getInt1Ty(*context_), value);
+    };
+    
+    // The first operand of a loop ID refers to the node itself
+    std::vector<llvm::Metadata*> hints = {nullptr};
+    for (const auto& annotation : annotations) {
+        std::string argument = annotation.arguments.empty() ? "" : annotation.arguments[0].second;
+        if (annotation.name == "unroll") {
+            hints.push_back(argument.empty() ? hint("llvm.loop.unroll.enable")
+                            : argument == "full" ? hint("llvm.loop.unroll.full")
+                                                 : hint("llvm.loop.unroll.count", count(argument)));
+        } else if (annotation.name == "no_unroll") {
+            hints.push_back(hint("llvm.loop.unroll.disable"));
+        } else if (annotation.name == "vectorize") {
+            hints.push_back(hint("llvm.loop.vectorize.enable", flag(true)));
+            if (!argument.empty()) {
+                hints.push_back(hint("llvm.loop.vectorize.width", count(argument)));
+            }
+        } else if (annotation.name == "no_vectorize") {
+            hints.push_back(hint("llvm.loop.vectorize.enable", flag(false)));
+        } else if (annotation.name == "interleave") {
+            hints.push_back(hint("llvm.loop.interleave.count", count(argument)));
+        }
+    }
+    llvm::MDNode* loop_id = llvm::MDNode::getDistinct(*context_, hints);
+    loop_id->replaceOperandWith(0, loop_id);
+    
+    // Every latch must carry the same ID; `continue` adds latches to a while loop
+    for (llvm::BasicBlock* pred : llvm::predecessors(header)) {
+        llvm::Instruction* latch = pred->getTerminator();
+        if (latch && latch != entry_branch) {
+            latch->setMetadata(llvm::LLVMContext::MD_loop, loop_id);
+        }
+    }
+}
+
 void CodeGenerator::generate_return_statement(ReturnStmt& stmt) {
     if (stmt.value) {
         llvm::Value* ret_value = generate_expression(*stmt.value);
@@ -932,6 +1759,7 @@ void CodeGenerator::generate_return_statement(ReturnStmt& stmt) {
             error("Failed to generate return value");
             return;
         }
+        mark_tail_call(ret_value);
         builder_->CreateRet(ret_value);
     } else {
         builder_->CreateRetVoid();
@@ -962,6 +1790,178 @@ void CodeGenerator::create_main_function() {
     functions_["main"] = main_func;
 }
 
+namespace {
+
+// Which memory a runtime function may touch besides its own stack
+enum class RuntimeMemory {
+    ReadArguments,      // Reads what its pointer arguments point to
+    ReadReachable,      // Reads through its arguments and the pointers stored there
+    Allocator,          // Only the allocator's private state (and the block it returns)
+    AllocatorReadArguments, // Allocates, and reads what its arguments point to
+    AllocatorArguments, // Allocator state, and reads or writes its arguments (free)
+};
+
+void set_runtime_memory(llvm::Function* func, RuntimeMemory memory) {
+#if LLVM_VERSION_MAJOR >= 16
+    using llvm::MemoryEffects;
+    using llvm::ModRefInfo;
+    switch (memory) {
+        case RuntimeMemory::ReadArguments:
+            func->setMemoryEffects(MemoryEffects::argMemOnly(ModRefInfo::Ref));
+            break;
+        case RuntimeMemory::ReadReachable:
+            func->setMemoryEffects(MemoryEffects::readOnly());
+            break;
+        case RuntimeMemory::Allocator:
+            func->setMemoryEffects(MemoryEffects::inaccessibleMemOnly());
+            break;
+        case RuntimeMemory::AllocatorReadArguments:
+            func->setMemoryEffects(MemoryEffects::inaccessibleMemOnly() | MemoryEffects::argMemOnly(ModRefInfo::Ref));
+            break;
+        case RuntimeMemory::AllocatorArguments:
+            func->setMemoryEffects(MemoryEffects::inaccessibleOrArgMemOnly());
+            break;
+    }
+#else
+    // No separate read/write per location before memory(...); read-only
+    // arguments are expressed by their parameter attributes instead
+    switch (memory) {
+        case RuntimeMemory::ReadArguments:
+            func->setOnlyReadsMemory();
+            func->setOnlyAccessesArgMemory();
+            break;
+        case RuntimeMemory::ReadReachable:
+            func->setOnlyReadsMemory();
+            break;
+        case RuntimeMemory::Allocator:
+            func->setOnlyAccessesInaccessibleMemory();
+            break;
+        case RuntimeMemory::AllocatorReadArguments:
+        case RuntimeMemory::AllocatorArguments:
+            func->setOnlyAccessesInaccessibleMemOrArgMem();
+            break;
+    }
+#endif
+}
+
+// Pointer parameters the callee only reads and does not keep
+void set_readonly_params(llvm::Function* func, std::initializer_list<unsigned> params) {
+    for (unsigned param : params) {
+        func->addParamAttr(param, llvm::Attribute::ReadOnly);
+        func->addParamAttr(param, llvm::Attribute::NoCapture);
+    }
+}
+
+} // namespace
+
+void CodeGenerator::annotate_runtime_functions() {
+    // Runtime functions never unwind. Only those that never allocate are
+    // willreturn: the rest stop the program when memory runs out, and reserve
+    // and resize also stop it on a size that was negative in its source.
+    for (const char* name : {"print", "println", "print_with_space", "ris_free", "ris_string_length",
+                             "ris_list_free", "ris_list_pop", "ris_list_size", "ris_list_get",
+                             "ris_list_fill", "ris_list_clear", "ris_list_equal",
+                             "ris_list_get_list", "ris_list_get_int", "ris_list_get_float",
+                             "ris_list_get_bool", "ris_list_get_char", "ris_list_get_string"}) {
+        functions_[name]->setDoesNotThrow();
+        functions_[name]->addFnAttr(llvm::Attribute::WillReturn);
+    }
+    
+    for (const char* name : {"ris_malloc", "ris_string_concat", "ris_list_create", "ris_list_from_array",
+                             "ris_list_init", "ris_list_init_from_array", "ris_list_push", "ris_list_push_value",
+                             "ris_list_reserve", "ris_list_resize", "ris_list_extend", "ris_list_copy"}) {
+        functions_[name]->setDoesNotThrow();
+    }
+    
+    llvm::Function* exit_func = functions_["ris_exit"];
+    exit_func->setDoesNotThrow();
+    exit_func->setDoesNotReturn();
+    
+    // print(type, value) reads the value, and for lists the elements behind it
+    for (const char* name : {"print", "println", "print_with_space"}) {
+        set_readonly_params(functions_[name], {1});
+    }
+    
+    // Allocators abort instead of returning null, so results are fresh and valid
+    llvm::Function* malloc_func = functions_["ris_malloc"];
+    set_runtime_memory(malloc_func, RuntimeMemory::Allocator);
+    malloc_func->addRetAttr(llvm::Attribute::NoAlias);
+    malloc_func->addRetAttr(llvm::Attribute::NonNull);
+    malloc_func->addFnAttr(llvm::Attribute::getWithAllocSizeArgs(*context_, 0, {}));
+    
+    llvm::Function* free_func = functions_["ris_free"];
+    set_runtime_memory(free_func, RuntimeMemory::AllocatorArguments);
+    free_func->addParamAttr(0, llvm::Attribute::NoCapture);
+    
+    llvm::Function* concat_func = functions_["ris_string_concat"];
+    set_runtime_memory(concat_func, RuntimeMemory::AllocatorReadArguments);
+    set_readonly_params(concat_func, {0, 1});
+    concat_func->addRetAttr(llvm::Attribute::NoAlias);
+    concat_func->addRetAttr(llvm::Attribute::NonNull);
+    
+    llvm::Function* length_func = functions_["ris_string_length"];
+    set_runtime_memory(length_func, RuntimeMemory::ReadArguments);
+    set_readonly_params(length_func, {0});
+    
+    llvm::Function* create_func = functions_["ris_list_create"];
+    set_runtime_memory(create_func, RuntimeMemory::Allocator);
+    create_func->addRetAttr(llvm::Attribute::NoAlias);
+    create_func->addRetAttr(llvm::Attribute::NonNull);
+    create_func->addRetAttr(llvm::Attribute::getWithDereferenceableBytes(*context_, sizeof(ris_list_t)));
+    
+    // Copies the constant table it is given and keeps no pointer into it
+    llvm::Function* from_array_func = functions_["ris_list_from_array"];
+    set_runtime_memory(from_array_func, RuntimeMemory::AllocatorReadArguments);
+    set_readonly_params(from_array_func, {1});
+    from_array_func->addRetAttr(llvm::Attribute::NoAlias);
+    from_array_func->addRetAttr(llvm::Attribute::NonNull);
+    from_array_func->addRetAttr(llvm::Attribute::getWithDereferenceableBytes(*context_, sizeof(ris_list_t)));
+    
+    // Mutators keep the list pointer only for the duration of the call. Those
+    // that may place elements in the header's inline cells store a pointer
+    // derived from it (resize, extend, push_value), or return one (pop), so
+    // they capture it.
+    for (const char* name : {"ris_list_free", "ris_list_push", "ris_list_reserve",
+                             "ris_list_fill", "ris_list_clear"}) {
+        functions_[name]->addParamAttr(0, llvm::Attribute::NoCapture);
+    }
+    set_readonly_params(functions_["ris_list_push_value"], {2});
+    
+    // Initializing a header points it at its own inline buffer, which
+    // captures the pointer; the table is only copied
+    set_readonly_params(functions_["ris_list_init_from_array"], {2});
+    set_readonly_params(functions_["ris_list_resize"], {3});
+    set_readonly_params(functions_["ris_list_fill"], {2});
+    set_readonly_params(functions_["ris_list_extend"], {2});
+    
+    llvm::Function* copy_func = functions_["ris_list_copy"];
+    set_readonly_params(copy_func, {0});
+    copy_func->addRetAttr(llvm::Attribute::NoAlias);
+    copy_func->addRetAttr(llvm::Attribute::NonNull);
+    copy_func->addRetAttr(llvm::Attribute::getWithDereferenceableBytes(*context_, sizeof(ris_list_t)));
+    
+    llvm::Function* equal_func = functions_["ris_list_equal"];
+    set_runtime_memory(equal_func, RuntimeMemory::ReadReachable);
+    set_readonly_params(equal_func, {0, 1});
+    
+    // The size lives in the header the argument points to
+    llvm::Function* size_func = functions_["ris_list_size"];
+    set_runtime_memory(size_func, RuntimeMemory::ReadArguments);
+    set_readonly_params(size_func, {0});
+    
+    // Getters also load through the header's data pointer
+    for (const char* name : {"ris_list_get_list", "ris_list_get_int", "ris_list_get_float",
+                             "ris_list_get_bool", "ris_list_get_char", "ris_list_get_string"}) {
+        set_runtime_memory(functions_[name], RuntimeMemory::ReadReachable);
+        set_readonly_params(functions_[name], {0});
+    }
+    
+    // ris_list_get may return one of the header's own inline cells
+    llvm::Function* get_func = functions_["ris_list_get"];
+    set_runtime_memory(get_func, RuntimeMemory::ReadReachable);
+    get_func->addParamAttr(0, llvm::Attribute::ReadOnly);
+}
+
 void CodeGenerator::declare_runtime_functions() {
     // Declare print functions
     auto void_type = llvm::Type::getVoidTy(*context_);
@@ -1037,6 +2037,32 @@ void CodeGenerator::declare_runtime_functions() {
         functions_["ris_list_create"] = func;
     }
     
+    // ris_list_from_array
+    {
+        auto func_type = llvm::FunctionType::get(list_type, {int32_type, llvm::PointerType::get(*context_, 0), size_t_type}, false);
+        auto func = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, "ris_list_from_array", module_.get());
+        functions_["ris_list_from_array"] = func;
+    }
+    
+    // Bulk list operations
+    {
+        auto ptr_type = llvm::PointerType::get(*context_, 0);
+        auto declare = [&](const char* name, llvm::Type* result, std::vector<llvm::Type*> params) {
+            auto func_type = llvm::FunctionType::get(result, params, false);
+            functions_[name] = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, name, module_.get());
+        };
+        declare("ris_list_reserve", void_type, {list_type, size_t_type});
+        declare("ris_list_resize", void_type, {list_type, size_t_type, int32_type, ptr_type});
+        declare("ris_list_fill", void_type, {list_type, int32_type, ptr_type});
+        declare("ris_list_clear", void_type, {list_type});
+        declare("ris_list_extend", void_type, {list_type, int32_type, list_type});
+        declare("ris_list_copy", list_type, {list_type, int32_type});
+        declare("ris_list_equal", llvm::Type::getInt8Ty(*context_), {list_type, list_type, int32_type});
+        declare("ris_list_init", void_type, {list_type, int32_type, size_t_type});
+        declare("ris_list_init_from_array", void_type, {list_type, int32_type, ptr_type, size_t_type});
+        declare("ris_list_push_value", void_type, {list_type, int32_type, ptr_type});
+    }
+    
     // ris_list_free
     {
         auto func_type = llvm::FunctionType::get(void_type, {list_type}, false);
@@ -1121,6 +2147,8 @@ void CodeGenerator::declare_runtime_functions() {
         auto func = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, "ris_exit", module_.get());
         functions_["ris_exit"] = func;
     }
+    
+    annotate_runtime_functions();
 }
 
 void CodeGenerator::generate_switch_statement(SwitchStmt& stmt) {
@@ -1212,6 +2240,28 @@ void CodeGenerator::generate_continue_statement(ContinueStmt& /* stmt */) {
     }
 }
 
+llvm::Constant* CodeGenerator::generate_literal_table(ListLiteralExpr& expr) {
+    // Only literals of one type can be laid out as a plain array
+    std::vector<llvm::Constant*> elements;
+    for (auto& element : expr.elements) {
+        auto* literal = dynamic_cast<LiteralExpr*>(element.get());
+        auto* value = literal ? llvm::dyn_cast_or_null<llvm::Constant>(generate_literal_expression(*literal)) : nullptr;
+        if (!value || (!elements.empty() && value->getType() != elements[0]->getType())) {
+            return nullptr;
+        }
+        elements.push_back(value);
+    }
+    if (elements.empty()) {
+        return nullptr;
+    }
+    
+    auto* table_type = llvm::ArrayType::get(elements[0]->getType(), elements.size());
+    auto* table = new llvm::GlobalVariable(*module_, table_type, true, llvm::GlobalValue::PrivateLinkage,
+                                           llvm::ConstantArray::get(table_type, elements), "list.table");
+    table->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    return table;
+}
+
 llvm::Value* CodeGenerator::generate_list_literal_expression(ListLiteralExpr& expr) {
     // Create a list using the runtime function
     auto list_create_func = functions_.find("ris_list_create");
@@ -1251,13 +2301,31 @@ llvm::Value* CodeGenerator::generate_list_literal_expression(ListLiteralExpr& ex
         }
     }
     
-    // Create the list
+    // Create the list. One that never leaves its function keeps its header,
+    // and so its first elements, in the stack frame
     auto element_type_val = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), element_type);
-    // Ensure minimum capacity of 4 for empty lists
-    size_t initial_capacity = std::max(expr.elements.size(), size_t(4));
-    auto capacity_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), initial_capacity);
+    llvm::Value* frame_list = nullptr;
+    if (expr.stack_allocated && builder_->GetInsertBlock()) {
+        frame_list = create_entry_alloca(list_header_type(), "list.frame");
+    }
+    if (auto* table = generate_literal_table(expr)) {
+        auto count_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), expr.elements.size());
+        if (frame_list) {
+            builder_->CreateCall(functions_["ris_list_init_from_array"], {frame_list, element_type_val, table, count_val});
+            return frame_list;
+        }
+        return builder_->CreateCall(functions_["ris_list_from_array"], {element_type_val, table, count_val});
+    }
+    
+    // The runtime rounds short lists up to its inline capacity
+    auto capacity_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), expr.elements.size());
     
-    auto list_ptr = builder_->CreateCall(list_create_func->second, {element_type_val, capacity_val});
+    llvm::Value* list_ptr = frame_list;
+    if (frame_list) {
+        builder_->CreateCall(functions_["ris_list_init"], {frame_list, element_type_val, capacity_val});
+    } else {
+        list_ptr = builder_->CreateCall(list_create_func->second, {element_type_val, capacity_val});
+    }
     
     // Add elements to the list
     for (auto& element : expr.elements) {
@@ -1266,84 +2334,43 @@ llvm::Value* CodeGenerator::generate_list_literal_expression(ListLiteralExpr& ex
             error("Failed to generate list element");
             return nullptr;
         }
-        
-        // Allocate space for the element value
-        llvm::Value* element_ptr = nullptr;
-        switch (element_type) {
-            case TYPE_INT: {
-                // Allocate heap memory for integer
-                auto malloc_func = functions_.find("ris_malloc");
-                if (malloc_func == functions_.end()) {
-                    error("ris_malloc function not found");
-                    return nullptr;
-                }
-                auto size_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), module_->getDataLayout().getTypeAllocSize(llvm::Type::getInt64Ty(*context_)));
-                element_ptr = builder_->CreateCall(malloc_func->second, {size_val});
-                builder_->CreateStore(element_val, element_ptr);
-                break;
-            }
-            case TYPE_FLOAT: {
-                // Allocate heap memory for float
-                auto malloc_func = functions_.find("ris_malloc");
-                if (malloc_func == functions_.end()) {
-                    error("ris_malloc function not found");
-                    return nullptr;
-                }
-                auto size_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), module_->getDataLayout().getTypeAllocSize(llvm::Type::getDoubleTy(*context_)));
-                element_ptr = builder_->CreateCall(malloc_func->second, {size_val});
-                builder_->CreateStore(element_val, element_ptr);
-                break;
-            }
-            case TYPE_BOOL: {
-                // Allocate heap memory for bool
-                auto malloc_func = functions_.find("ris_malloc");
-                if (malloc_func == functions_.end()) {
-                    error("ris_malloc function not found");
-                    return nullptr;
-                }
-                auto size_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), module_->getDataLayout().getTypeAllocSize(llvm::Type::getInt8Ty(*context_)));
-                element_ptr = builder_->CreateCall(malloc_func->second, {size_val});
-                builder_->CreateStore(element_val, element_ptr);
-                break;
-            }
-            case TYPE_CHAR: {
-                // Allocate heap memory for char
-                auto malloc_func = functions_.find("ris_malloc");
-                if (malloc_func == functions_.end()) {
-                    error("ris_malloc function not found");
-                    return nullptr;
-                }
-                auto size_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), module_->getDataLayout().getTypeAllocSize(llvm::Type::getInt8Ty(*context_)));
-                element_ptr = builder_->CreateCall(malloc_func->second, {size_val});
-                builder_->CreateStore(element_val, element_ptr);
-                break;
-            }
-            case TYPE_STRING: {
-                element_ptr = element_val; // String literals are already pointers
-                break;
-            }
-            case TYPE_LIST: {
-                element_ptr = element_val; // List literals are already pointers
-                break;
-            }
-            default:
-                error("Unsupported list element type");
-                return nullptr;
-        }
-        
-        // Push the element to the list
-        auto list_push_func = functions_.find("ris_list_push");
-        if (list_push_func != functions_.end()) {
-            builder_->CreateCall(list_push_func->second, {list_ptr, element_ptr});
-        }
+        generate_list_push(list_ptr, element_type, element_val);
     }
     
     return list_ptr;
 }
 
+void CodeGenerator::generate_list_push(llvm::Value* list, int element_tag, llvm::Value* value) {
+    // Strings and nested lists are stored in the slot itself
+    if (element_tag == TYPE_STRING || element_tag == TYPE_LIST) {
+        builder_->CreateCall(functions_["ris_list_push"], {list, value});
+        return;
+    }
+    
+    // Scalars are copied into a cell the list provides, so the first few
+    // need no allocation of their own
+    llvm::Value* address = create_entry_alloca(value->getType(), "push.value");
+    set_tbaa(builder_->CreateStore(value, address), "ris variable");
+    auto tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), element_tag);
+    builder_->CreateCall(functions_["ris_list_push_value"], {list, tag, address});
+}
+
+llvm::Value* CodeGenerator::generate_list_operand(Expr& expr) {
+    // In `m[i][j]` the inner index yields a nested list, whatever its own list holds
+    if (auto* inner = dynamic_cast<ListIndexExpr*>(&expr)) {
+        llvm::Value* list = generate_list_operand(*inner->list);
+        llvm::Value* index = inner->index ? generate_expression(*inner->index) : nullptr;
+        if (!list || !index) {
+            return nullptr;
+        }
+        return generate_list_get(list, index, TYPE_LIST, functions_["ris_list_get_list"]);
+    }
+    return generate_expression(expr);
+}
+
 llvm::Value* CodeGenerator::generate_list_index_expression(ListIndexExpr& expr) {
     // Generate the list expression
-    auto list_value = generate_expression(*expr.list);
+    auto list_value = generate_list_operand(*expr.list);
     if (!list_value) {
         error("Failed to generate list expression");
         return nullptr;
@@ -1418,7 +2445,7 @@ llvm::Value* CodeGenerator::generate_list_index_expression(ListIndexExpr& expr)
     
     auto get_func = functions_.find(func_name);
     if (get_func != functions_.end()) {
-        return builder_->CreateCall(get_func->second, {list_value, index_value});
+        return generate_list_get(list_value, index_value, element_type, get_func->second);
     }
     
     error(func_name + " function not found");
@@ -1427,7 +2454,7 @@ llvm::Value* CodeGenerator::generate_list_index_expression(ListIndexExpr& expr)
 
 llvm::Value* CodeGenerator::generate_list_method_call_expression(ListMethodCallExpr& expr) {
     // Generate the list expression
-    auto list_value = generate_expression(*expr.list);
+    auto list_value = generate_list_operand(*expr.list);
     if (!list_value) {
         error("Failed to generate list expression");
         return nullptr;
@@ -1496,50 +2523,12 @@ llvm::Value* CodeGenerator::generate_list_method_call_expression(ListMethodCallE
             element_type = TYPE_LIST;
         }
         
-        // Allocate space for the argument based on element type
-        llvm::Value* element_ptr;
-        if (element_type == TYPE_LIST) {
-            // For lists, the argument is already a pointer
-            element_ptr = arg_value;
-        } else {
-            // For primitive types, allocate heap memory and store the value
-            llvm::Type* element_llvm_type;
-            switch (element_type) {
-                case TYPE_INT:
-                    element_llvm_type = llvm::Type::getInt64Ty(*context_);
-                    break;
-                case TYPE_FLOAT:
-                    element_llvm_type = llvm::Type::getDoubleTy(*context_);
-                    break;
-                case TYPE_BOOL:
-                case TYPE_CHAR:
-                    element_llvm_type = llvm::Type::getInt8Ty(*context_);
-                    break;
-                case TYPE_STRING:
-                    element_llvm_type = llvm::PointerType::get(*context_, 0);
-                    break;
-                default:
-                    element_llvm_type = llvm::Type::getInt64Ty(*context_);
-                    break;
-            }
-            
-            // Allocate heap memory using ris_malloc
-            auto malloc_func = functions_.find("ris_malloc");
-            if (malloc_func == functions_.end()) {
-                error("ris_malloc function not found");
-                return nullptr;
-            }
-            
-            auto size_val = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), module_->getDataLayout().getTypeAllocSize(element_llvm_type));
-            element_ptr = builder_->CreateCall(malloc_func->second, {size_val});
-            builder_->CreateStore(arg_value, element_ptr);
+        // Semantic analysis knows the list's type where the guesses above do not
+        if (!expr.element_type.empty()) {
+            element_type = element_tag(expr.element_type);
         }
         
-        // Call ris_list_push
-        auto push_func = functions_.find("ris_list_push");
-        if (push_func != functions_.end()) {
-            builder_->CreateCall(push_func->second, {list_value, element_ptr});
-        }
+        generate_list_push(list_value, element_type, arg_value);
         
         return nullptr; // push returns void
         
@@ -1660,7 +2649,7 @@ llvm::Value* CodeGenerator::generate_list_method_call_expression(ListMethodCallE
             
             auto get_func = functions_.find(func_name);
             if (get_func != functions_.end()) {
-                return builder_->CreateCall(get_func->second, {list_value, index_value});
+                return generate_list_get(list_value, index_value, element_type, get_func->second);
             }
             
             error(func_name + " function not found");
@@ -1674,46 +2663,58 @@ llvm::Value* CodeGenerator::generate_list_method_call_expression(ListMethodCallE
         
         return nullptr;
         
+    } else if (expr.method_name == "reserve" || expr.method_name == "resize" || expr.method_name == "fill" ||
+               expr.method_name == "clear" || expr.method_name == "extend" || expr.method_name == "copy") {
+        return generate_list_bulk_operation(expr, list_value);
     } else {
         error("Unknown list method: " + expr.method_name);
         return nullptr;
     }
 }
 
+llvm::Value* CodeGenerator::generate_list_bulk_operation(ListMethodCallExpr& expr, llvm::Value* list) {
+    // Semantic analysis has checked the arguments
+    std::vector<llvm::Value*> arguments;
+    for (auto& arg : expr.arguments) {
+        llvm::Value* value = generate_expression(*arg);
+        if (!value) {
+            error("Failed to generate " + expr.method_name + " argument");
+            return nullptr;
+        }
+        arguments.push_back(value);
+    }
+    
+    auto tag = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context_), element_tag(expr.element_type));
+    // The element for resize and fill is passed by address, as in a list cell
+    auto element_address = [this](llvm::Value* value) {
+        llvm::Value* address = create_entry_alloca(value->getType());
+        set_tbaa(builder_->CreateStore(value, address), "ris variable");
+        return address;
+    };
+    llvm::Function* func = functions_["ris_list_" + expr.method_name];
+    
+    if (expr.method_name == "reserve") {
+        return builder_->CreateCall(func, {list, arguments[0]});
+    } else if (expr.method_name == "resize") {
+        return builder_->CreateCall(func, {list, arguments[0], tag, element_address(arguments[1])});
+    } else if (expr.method_name == "fill") {
+        return builder_->CreateCall(func, {list, tag, element_address(arguments[0])});
+    } else if (expr.method_name == "clear") {
+        return builder_->CreateCall(func, {list});
+    } else if (expr.method_name == "extend") {
+        return builder_->CreateCall(func, {list, tag, arguments[0]});
+    }
+    return builder_->CreateCall(func, {list, tag}, "list.copy");
+}
+
 llvm::Value* CodeGenerator::generate_pre_increment_expression(PreIncrementExpr& expr) {
     if (!expr.operand) {
         error("Expected operand for pre-increment");
         return nullptr;
     }
     
-    // Generate the operand (must be an identifier)
-    auto* identifier = dynamic_cast<IdentifierExpr*>(expr.operand.get());
-    if (!identifier) {
-        error("Pre-increment operand must be a variable");
-        return nullptr;
-    }
-    
-    // Get the variable's current value
-    auto var_value = generate_identifier_expression(*identifier);
-    if (!var_value) {
-        error("Failed to generate variable reference");
-        return nullptr;
-    }
-    
-    // Create a new value (current + 1)
-    auto one = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), 1);
-    auto new_value = builder_->CreateAdd(var_value, one);
-    
-    // Store the new value back to the variable
-    auto var_it = named_values_.find(identifier->name);
-    if (var_it == named_values_.end()) {
-        error("Variable not found: " + identifier->name);
-        return nullptr;
-    }
-    builder_->CreateStore(new_value, var_it->second);
-    
-    // Return the new value (pre-increment returns the incremented value)
-    return new_value;
+    // Pre-increment returns the incremented value
+    return generate_assignment(*expr.operand, TokenType::PLUS, nullptr, false);
 }
 
 llvm::Value* CodeGenerator::generate_post_increment_expression(PostIncrementExpr& expr) {
@@ -1722,34 +2723,8 @@ llvm::Value* CodeGenerator::generate_post_increment_expression(PostIncrementExpr
         return nullptr;
     }
     
-    // Generate the operand (must be an identifier)
-    auto* identifier = dynamic_cast<IdentifierExpr*>(expr.operand.get());
-    if (!identifier) {
-        error("Post-increment operand must be a variable");
-        return nullptr;
-    }
-    
-    // Get the variable's current value
-    auto var_value = generate_identifier_expression(*identifier);
-    if (!var_value) {
-        error("Failed to generate variable reference");
-        return nullptr;
-    }
-    
-    // Create a new value (current + 1)
-    auto one = llvm::ConstantInt::get(llvm::Type::getInt64Ty(*context_), 1);
-    auto new_value = builder_->CreateAdd(var_value, one);
-    
-    // Store the new value back to the variable
-    auto var_it = named_values_.find(identifier->name);
-    if (var_it == named_values_.end()) {
-        error("Variable not found: " + identifier->name);
-        return nullptr;
-    }
-    builder_->CreateStore(new_value, var_it->second);
-    
-    // Return the original value (post-increment returns the original value)
-    return var_value;
+    // Post-increment returns the original value
+    return generate_assignment(*expr.operand, TokenType::PLUS, nullptr, true);
 }
 
 } // namespace ris
\ No newline at end of file
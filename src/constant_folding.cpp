@@ -0,0 +1,1018 @@
+#include "constant_folding.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ris {
+
+namespace {
+
+// Literals too large for 64 bits are left for codegen to report
+bool parse_int(const std::string& text, int64_t& value) {
+    errno = 0;
+    char* end = nullptr;
+    value = std::strtoll(text.c_str(), &end, 10);
+    return errno == 0 && end && *end == '\0';
+}
+
+// Limits on one compile-time evaluation; past them the code is left to run
+constexpr size_t kMaxSteps = 1000000;
+constexpr size_t kMaxCallDepth = 256;
+constexpr size_t kMaxListSize = 65536;
+
+// A value known at compile time. Lists are shared by reference, as at run
+// time; only lists of int are modelled.
+struct Value {
+    enum class Kind { Void, Int, Float, Bool, Char, String, List };
+    Kind kind = Kind::Void;
+    int64_t integer = 0; // Int, Bool and Char
+    double number = 0.0;
+    std::string text;
+    std::shared_ptr<std::vector<int64_t>> list;
+};
+
+Value make_value(Value::Kind kind, int64_t integer) {
+    Value value;
+    value.kind = kind;
+    value.integer = integer;
+    return value;
+}
+
+Value make_number(double number) {
+    Value value;
+    value.kind = Value::Kind::Float;
+    value.number = number;
+    return value;
+}
+
+Value make_text(std::string text) {
+    Value value;
+    value.kind = Value::Kind::String;
+    value.text = std::move(text);
+    return value;
+}
+
+bool literal_value(const LiteralExpr& literal, Value& value) {
+    switch (literal.type) {
+        case TokenType::INTEGER_LITERAL: {
+            int64_t integer;
+            if (!parse_int(literal.value, integer)) {
+                return false;
+            }
+            value = make_value(Value::Kind::Int, integer);
+            return true;
+        }
+        case TokenType::FLOAT_LITERAL:
+            value = make_number(std::stod(literal.value));
+            return true;
+        case TokenType::CHAR_LITERAL:
+            value = make_value(Value::Kind::Char, literal.value[0]);
+            return true;
+        case TokenType::STRING_LITERAL:
+            value = make_text(literal.value);
+            return true;
+        case TokenType::TRUE:
+        case TokenType::FALSE:
+            value = make_value(Value::Kind::Bool, literal.type == TokenType::TRUE);
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::unique_ptr<Expr> make_bool(bool value, const SourcePos& pos) {
+    return std::make_unique<LiteralExpr>(value ? "true" : "false", value ? TokenType::TRUE : TokenType::FALSE, pos);
+}
+
+std::unique_ptr<Expr> make_int(int64_t value, const SourcePos& pos) {
+    return std::make_unique<LiteralExpr>(std::to_string(value), TokenType::INTEGER_LITERAL, pos);
+}
+
+// Shortest text that reads back as the same double
+std::unique_ptr<Expr> make_float(double value, const SourcePos& pos) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    std::string text = buffer;
+    if (text.find_first_of(".e") == std::string::npos) {
+        text += ".0";
+    }
+    return std::make_unique<LiteralExpr>(text, TokenType::FLOAT_LITERAL, pos);
+}
+
+// The literal that produces a value, or null when it has no spelling
+std::unique_ptr<Expr> make_literal(const Value& value, const SourcePos& pos) {
+    switch (value.kind) {
+        case Value::Kind::Int:
+            return make_int(value.integer, pos);
+        case Value::Kind::Float:
+            // Infinities and NaN have no literal spelling
+            return std::isfinite(value.number) ? make_float(value.number, pos) : nullptr;
+        case Value::Kind::Bool:
+            return make_bool(value.integer != 0, pos);
+        case Value::Kind::Char:
+            return std::make_unique<LiteralExpr>(std::string(1, static_cast<char>(value.integer)), TokenType::CHAR_LITERAL, pos);
+        case Value::Kind::String:
+            return std::make_unique<LiteralExpr>(value.text, TokenType::STRING_LITERAL, pos);
+        case Value::Kind::List: {
+            auto list = std::make_unique<ListLiteralExpr>(pos);
+            for (int64_t element : *value.list) {
+                list->elements.push_back(make_int(element, pos));
+            }
+            return list;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+bool is_literal_tree(const Expr* expr) {
+    if (auto* list = dynamic_cast<const ListLiteralExpr*>(expr)) {
+        for (const auto& element : list->elements) {
+            if (!is_literal_tree(element.get())) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return dynamic_cast<const LiteralExpr*>(expr) != nullptr;
+}
+
+// Compare with the operator's meaning; ordered comparisons as the generated fcmp/icmp do
+template <typename T>
+bool compare(TokenType op, T left, T right, Value& result) {
+    bool value;
+    switch (op) {
+        case TokenType::EQUAL: value = left == right; break;
+        case TokenType::NOT_EQUAL: value = left != right; break;
+        case TokenType::LESS: value = left < right; break;
+        case TokenType::GREATER: value = left > right; break;
+        case TokenType::LESS_EQUAL: value = left <= right; break;
+        case TokenType::GREATER_EQUAL: value = left >= right; break;
+        default: return false;
+    }
+    result = make_value(Value::Kind::Bool, value);
+    return true;
+}
+
+bool apply_ints(TokenType op, int64_t left, int64_t right, Value& result) {
+    // Two's complement wrap-around, like the add/sub/mul the code generator emits
+    uint64_t a = static_cast<uint64_t>(left);
+    uint64_t b = static_cast<uint64_t>(right);
+    switch (op) {
+        case TokenType::PLUS: result = make_value(Value::Kind::Int, static_cast<int64_t>(a + b)); return true;
+        case TokenType::MINUS: result = make_value(Value::Kind::Int, static_cast<int64_t>(a - b)); return true;
+        case TokenType::MULTIPLY: result = make_value(Value::Kind::Int, static_cast<int64_t>(a * b)); return true;
+        case TokenType::DIVIDE:
+            // These trap at run time; keep them there
+            if (right == 0 || (left == INT64_MIN && right == -1)) {
+                return false;
+            }
+            result = make_value(Value::Kind::Int, left / right);
+            return true;
+        default:
+            return compare(op, left, right, result);
+    }
+}
+
+bool apply_floats(TokenType op, double left, double right, Value& result) {
+    switch (op) {
+        case TokenType::PLUS: result = make_number(left + right); return true;
+        case TokenType::MINUS: result = make_number(left - right); return true;
+        case TokenType::MULTIPLY: result = make_number(left * right); return true;
+        case TokenType::DIVIDE: result = make_number(left / right); return true;
+        default: return compare(op, left, right, result);
+    }
+}
+
+// Evaluate a binary operator on two known operands, or return false when
+// the generated code would do something else (or nothing well defined)
+bool apply_binary(TokenType op, const Value& left, const Value& right, Value& result) {
+    if (left.kind != right.kind) {
+        return false;
+    }
+    switch (left.kind) {
+        case Value::Kind::Int:
+            return apply_ints(op, left.integer, right.integer, result);
+        case Value::Kind::Float:
+            return apply_floats(op, left.number, right.number, result);
+        case Value::Kind::Char:
+            return compare(op, static_cast<char>(left.integer), static_cast<char>(right.integer), result);
+        case Value::Kind::String:
+            // Strings compare by address at run time, so only + is known
+            if (op != TokenType::PLUS) {
+                return false;
+            }
+            result = make_text(left.text + right.text);
+            return true;
+        case Value::Kind::Bool: {
+            bool a = left.integer != 0;
+            bool b = right.integer != 0;
+            switch (op) {
+                case TokenType::AND: result = make_value(Value::Kind::Bool, a && b); return true;
+                case TokenType::OR: result = make_value(Value::Kind::Bool, a || b); return true;
+                case TokenType::EQUAL: result = make_value(Value::Kind::Bool, a == b); return true;
+                case TokenType::NOT_EQUAL: result = make_value(Value::Kind::Bool, a != b); return true;
+                default: return false;
+            }
+        }
+        default:
+            return false;
+    }
+}
+
+bool apply_unary(TokenType op, const Value& operand, Value& result) {
+    if (op == TokenType::NOT && operand.kind == Value::Kind::Bool) {
+        result = make_value(Value::Kind::Bool, operand.integer == 0);
+        return true;
+    }
+    if (op == TokenType::MINUS && operand.kind == Value::Kind::Int) {
+        result = make_value(Value::Kind::Int, static_cast<int64_t>(0 - static_cast<uint64_t>(operand.integer)));
+        return true;
+    }
+    if (op == TokenType::MINUS && operand.kind == Value::Kind::Float) {
+        result = make_number(-operand.number);
+        return true;
+    }
+    return false;
+}
+
+std::unique_ptr<Expr> fold_binary(BinaryExpr& expr) {
+    auto* left = dynamic_cast<LiteralExpr*>(expr.left.get());
+    auto* right = dynamic_cast<LiteralExpr*>(expr.right.get());
+    Value left_value, right_value, result;
+    if (!left || !literal_value(*left, left_value)) {
+        return nullptr;
+    }
+
+    // The right side of `false && e` and `true || e` never runs
+    if (left_value.kind == Value::Kind::Bool) {
+        bool value = left_value.integer != 0;
+        if ((expr.op == TokenType::AND && !value) || (expr.op == TokenType::OR && value)) {
+            return make_bool(value, expr.position);
+        }
+    }
+
+    if (!right || !literal_value(*right, right_value) || !apply_binary(expr.op, left_value, right_value, result)) {
+        return nullptr;
+    }
+    return make_literal(result, expr.position);
+}
+
+std::unique_ptr<Expr> fold_unary(UnaryExpr& expr) {
+    auto* operand = dynamic_cast<LiteralExpr*>(expr.operand.get());
+    Value value, result;
+    if (!operand || !literal_value(*operand, value) || !apply_unary(expr.op, value, result)) {
+        return nullptr;
+    }
+    return make_literal(result, expr.position);
+}
+
+// Runs const functions and global initializers on Values the way the
+// generated code would. Anything it does not model, such as a switch, a
+// call to a non-const function or an out-of-range index, fails the whole
+// evaluation, and the code is left to run as usual.
+class Interpreter {
+public:
+    Interpreter(const std::map<std::string, FuncDecl*>& functions, const std::map<std::string, Value>& globals)
+        : functions_(functions), globals_(globals) {}
+
+    // Evaluate an expression outside any function, with only the globals in view
+    bool evaluate(Expr& expr, Value& result) {
+        steps_ = 0;
+        depth_ = 0;
+        scopes_.clear();
+        return eval(expr, result);
+    }
+
+private:
+    enum class Flow { Next, Break, Continue, Return, Fail };
+
+    const std::map<std::string, FuncDecl*>& functions_;
+    const std::map<std::string, Value>& globals_;
+    std::vector<std::map<std::string, Value>> scopes_; // The running call's, innermost last
+    Value return_value_;
+    size_t steps_ = 0;
+    size_t depth_ = 0;
+
+    bool step() {
+        return ++steps_ <= kMaxSteps;
+    }
+
+    Value* local(const std::string& name) {
+        for (auto scope = scopes_.rbegin(); scope != scopes_.rend(); ++scope) {
+            auto it = scope->find(name);
+            if (it != scope->end()) {
+                return &it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    bool eval_bool(Expr& expr, bool& result) {
+        Value value;
+        if (!eval(expr, value) || value.kind != Value::Kind::Bool) {
+            return false;
+        }
+        result = value.integer != 0;
+        return true;
+    }
+
+    bool eval_int(Expr& expr, int64_t& result) {
+        Value value;
+        if (!eval(expr, value) || value.kind != Value::Kind::Int) {
+            return false;
+        }
+        result = value.integer;
+        return true;
+    }
+
+    bool eval_list(Expr& expr, std::shared_ptr<std::vector<int64_t>>& result) {
+        Value value;
+        if (!eval(expr, value) || value.kind != Value::Kind::List) {
+            return false;
+        }
+        result = value.list;
+        return true;
+    }
+
+    bool eval(Expr& expr, Value& result) {
+        if (!step()) {
+            return false;
+        }
+
+        if (auto* literal = dynamic_cast<LiteralExpr*>(&expr)) {
+            return literal_value(*literal, result);
+        } else if (auto* identifier = dynamic_cast<IdentifierExpr*>(&expr)) {
+            if (Value* value = local(identifier->name)) {
+                result = *value;
+                return true;
+            }
+            auto global = globals_.find(identifier->name);
+            if (scopes_.empty() && global != globals_.end()) {
+                result = global->second;
+                return true;
+            }
+            return false;
+        } else if (auto* binary = dynamic_cast<BinaryExpr*>(&expr)) {
+            return eval_binary(*binary, result);
+        } else if (auto* unary = dynamic_cast<UnaryExpr*>(&expr)) {
+            Value operand;
+            return unary->operand && eval(*unary->operand, operand) && apply_unary(unary->op, operand, result);
+        } else if (auto* call = dynamic_cast<CallExpr*>(&expr)) {
+            return eval_call(*call, result);
+        } else if (auto* list = dynamic_cast<ListLiteralExpr*>(&expr)) {
+            if (list->elements.size() > kMaxListSize) {
+                return false;
+            }
+            result = Value();
+            result.kind = Value::Kind::List;
+            result.list = std::make_shared<std::vector<int64_t>>();
+            for (auto& element : list->elements) {
+                int64_t value;
+                if (!eval_int(*element, value)) {
+                    return false;
+                }
+                result.list->push_back(value);
+            }
+            return true;
+        } else if (auto* index = dynamic_cast<ListIndexExpr*>(&expr)) {
+            std::shared_ptr<std::vector<int64_t>> list;
+            int64_t position;
+            // Out of range reads yield 0 at run time; leave them there
+            if (!eval_list(*index->list, list) || !eval_int(*index->index, position) || position < 0 ||
+                static_cast<uint64_t>(position) >= list->size()) {
+                return false;
+            }
+            result = make_value(Value::Kind::Int, (*list)[position]);
+            return true;
+        } else if (auto* method = dynamic_cast<ListMethodCallExpr*>(&expr)) {
+            return eval_method(*method, result);
+        } else if (auto* pre_inc = dynamic_cast<PreIncrementExpr*>(&expr)) {
+            return increment(*pre_inc->operand, true, result);
+        } else if (auto* post_inc = dynamic_cast<PostIncrementExpr*>(&expr)) {
+            return increment(*post_inc->operand, false, result);
+        }
+        return false;
+    }
+
+    bool eval_binary(BinaryExpr& expr, Value& result) {
+        if (!expr.left || !expr.right) {
+            return false;
+        }
+
+        if (is_assignment_operator(expr.op)) {
+            return assign(*expr.left, compound_assignment_operator(expr.op), expr.right.get(), false, result);
+        }
+
+        if (expr.op == TokenType::AND || expr.op == TokenType::OR) {
+            bool left, right;
+            if (!eval_bool(*expr.left, left)) {
+                return false;
+            }
+            if (left == (expr.op == TokenType::OR)) {
+                result = make_value(Value::Kind::Bool, left);
+                return true;
+            }
+            if (!eval_bool(*expr.right, right)) {
+                return false;
+            }
+            result = make_value(Value::Kind::Bool, right);
+            return true;
+        }
+
+        Value left, right;
+        if (!eval(*expr.left, left) || !eval(*expr.right, right)) {
+            return false;
+        }
+        // Lists compare by their elements
+        if (left.kind == Value::Kind::List && right.kind == Value::Kind::List &&
+            (expr.op == TokenType::EQUAL || expr.op == TokenType::NOT_EQUAL)) {
+            result = make_value(Value::Kind::Bool, (*left.list == *right.list) == (expr.op == TokenType::EQUAL));
+            return true;
+        }
+        return apply_binary(expr.op, left, right, result);
+    }
+
+    bool eval_call(CallExpr& expr, Value& result) {
+        std::vector<Value> arguments(expr.arguments.size());
+        for (size_t i = 0; i < expr.arguments.size(); ++i) {
+            if (!eval(*expr.arguments[i], arguments[i])) {
+                return false;
+            }
+        }
+
+        if (expr.function_name == "likely" || expr.function_name == "unlikely") {
+            result = arguments.size() == 1 ? arguments[0] : Value();
+            return result.kind == Value::Kind::Bool;
+        }
+        if (expr.function_name == "ris_string_length") {
+            if (arguments.size() != 1 || arguments[0].kind != Value::Kind::String) {
+                return false;
+            }
+            result = make_value(Value::Kind::Int, static_cast<int64_t>(std::strlen(arguments[0].text.c_str())));
+            return true;
+        }
+
+        auto function = functions_.find(expr.function_name);
+        if (function == functions_.end() || arguments.size() != function->second->parameters.size() ||
+            depth_ >= kMaxCallDepth) {
+            return false;
+        }
+        FuncDecl& func = *function->second;
+
+        // The callee sees its parameters only
+        std::vector<std::map<std::string, Value>> caller_scopes;
+        caller_scopes.swap(scopes_);
+        scopes_.emplace_back();
+        for (size_t i = 0; i < arguments.size(); ++i) {
+            scopes_.back()[func.parameters[i].second] = arguments[i];
+        }
+
+        ++depth_;
+        Flow flow = exec_statements(func.body->statements);
+        --depth_;
+        scopes_.swap(caller_scopes);
+
+        if (flow == Flow::Return) {
+            result = return_value_;
+            return func.return_type == "void" || result.kind != Value::Kind::Void;
+        }
+        // Falling off the end is only defined for void functions
+        result = Value();
+        return flow == Flow::Next && func.return_type == "void";
+    }
+
+    bool eval_method(ListMethodCallExpr& expr, Value& result) {
+        std::shared_ptr<std::vector<int64_t>> list;
+        if (!expr.list || !eval_list(*expr.list, list)) {
+            return false;
+        }
+
+        if (expr.method_name == "size" && expr.arguments.empty()) {
+            result = make_value(Value::Kind::Int, static_cast<int64_t>(list->size()));
+            return true;
+        }
+        if (expr.method_name == "push" && expr.arguments.size() == 1) {
+            int64_t value;
+            if (list->size() >= kMaxListSize || !eval_int(*expr.arguments[0], value)) {
+                return false;
+            }
+            list->push_back(value);
+            result = Value();
+            return true;
+        }
+        if (expr.method_name == "copy" && expr.arguments.empty()) {
+            result = make_value(Value::Kind::List, 0);
+            result.list = std::make_shared<std::vector<int64_t>>(*list);
+            return true;
+        }
+        if (expr.method_name == "clear" && expr.arguments.empty()) {
+            list->clear();
+            result = Value();
+            return true;
+        }
+        if (expr.method_name == "reserve" && expr.arguments.size() == 1) {
+            int64_t capacity;
+            result = Value();
+            return eval_int(*expr.arguments[0], capacity);
+        }
+        if (expr.method_name == "fill" && expr.arguments.size() == 1) {
+            int64_t value;
+            if (!eval_int(*expr.arguments[0], value)) {
+                return false;
+            }
+            std::fill(list->begin(), list->end(), value);
+            result = Value();
+            return true;
+        }
+        if (expr.method_name == "resize" && expr.arguments.size() == 2) {
+            int64_t size, value;
+            if (!eval_int(*expr.arguments[0], size) || !eval_int(*expr.arguments[1], value) || size < 0 ||
+                static_cast<uint64_t>(size) > kMaxListSize) {
+                return false;
+            }
+            list->resize(static_cast<size_t>(size), value);
+            result = Value();
+            return true;
+        }
+        if (expr.method_name == "extend" && expr.arguments.size() == 1) {
+            std::shared_ptr<std::vector<int64_t>> other;
+            if (!eval_list(*expr.arguments[0], other) || list->size() + other->size() > kMaxListSize) {
+                return false;
+            }
+            std::vector<int64_t> elements = *other;
+            list->insert(list->end(), elements.begin(), elements.end());
+            result = Value();
+            return true;
+        }
+        // pop() hands back the runtime's boxed element; only its effect is modelled
+        return false;
+    }
+
+    bool increment(Expr& operand, bool pre, Value& result) {
+        return assign(operand, TokenType::PLUS, nullptr, !pre, result);
+    }
+
+    // Mirrors CodeGenerator::generate_assignment: `op` is ASSIGN for a plain
+    // store, otherwise the arithmetic applied to the old value; a missing
+    // `value` is the 1 that ++ adds
+    bool assign(Expr& target, TokenType op, Expr* value, bool return_old, Value& result) {
+        Value operand = make_value(Value::Kind::Int, 1);
+        Value old_value, new_value;
+        if (auto* identifier = dynamic_cast<IdentifierExpr*>(&target)) {
+            if (!local(identifier->name)) {
+                return false;
+            }
+            old_value = *local(identifier->name);
+            if ((value && !eval(*value, operand)) || !local(identifier->name)) {
+                return false;
+            }
+            new_value = operand;
+            if (op != TokenType::ASSIGN && !apply_binary(op, old_value, operand, new_value)) {
+                return false;
+            }
+            *local(identifier->name) = new_value;
+        } else if (auto* element = dynamic_cast<ListIndexExpr*>(&target)) {
+            std::shared_ptr<std::vector<int64_t>> list;
+            int64_t position;
+            // Out of range stores are dropped at run time; leave them there
+            if (!eval_list(*element->list, list) || !eval_int(*element->index, position) ||
+                (value && !eval(*value, operand)) || position < 0 || static_cast<uint64_t>(position) >= list->size()) {
+                return false;
+            }
+            old_value = make_value(Value::Kind::Int, (*list)[position]);
+            new_value = operand;
+            if ((op != TokenType::ASSIGN && !apply_binary(op, old_value, operand, new_value)) ||
+                new_value.kind != Value::Kind::Int) {
+                return false;
+            }
+            (*list)[position] = new_value.integer;
+        } else {
+            return false;
+        }
+        result = return_old ? old_value : new_value;
+        return true;
+    }
+
+    bool default_value(const std::string& type, Value& value) {
+        if (type == "int") {
+            value = make_value(Value::Kind::Int, 0);
+        } else if (type == "float") {
+            value = make_number(0.0);
+        } else if (type == "bool") {
+            value = make_value(Value::Kind::Bool, 0);
+        } else if (type == "char") {
+            value = make_value(Value::Kind::Char, 0);
+        } else {
+            // Strings and lists start out null
+            return false;
+        }
+        return true;
+    }
+
+    Flow exec_statements(const std::vector<std::unique_ptr<Stmt>>& statements) {
+        scopes_.emplace_back();
+        Flow flow = Flow::Next;
+        for (const auto& stmt : statements) {
+            flow = exec(*stmt);
+            if (flow != Flow::Next) {
+                break;
+            }
+        }
+        scopes_.pop_back();
+        return flow;
+    }
+
+    Flow exec(Stmt& stmt) {
+        if (!step()) {
+            return Flow::Fail;
+        }
+
+        if (auto* var = dynamic_cast<VarDecl*>(&stmt)) {
+            Value value;
+            bool ok = var->initializer ? eval(*var->initializer, value) : default_value(var->type, value);
+            if (!ok) {
+                return Flow::Fail;
+            }
+            scopes_.back()[var->name] = value;
+            return Flow::Next;
+        } else if (auto* block = dynamic_cast<BlockStmt*>(&stmt)) {
+            return exec_statements(block->statements);
+        } else if (auto* if_stmt = dynamic_cast<IfStmt*>(&stmt)) {
+            bool condition;
+            if (!eval_bool(*if_stmt->condition, condition)) {
+                return Flow::Fail;
+            }
+            Stmt* branch = condition ? if_stmt->then_branch.get() : if_stmt->else_branch.get();
+            return branch ? exec(*branch) : Flow::Next;
+        } else if (auto* while_stmt = dynamic_cast<WhileStmt*>(&stmt)) {
+            return exec_loop(while_stmt->condition.get(), nullptr, *while_stmt->body);
+        } else if (auto* for_stmt = dynamic_cast<ForStmt*>(&stmt)) {
+            scopes_.emplace_back();
+            Flow flow = for_stmt->init ? exec(*for_stmt->init) : Flow::Next;
+            if (flow == Flow::Next) {
+                flow = exec_loop(for_stmt->condition.get(), for_stmt->update.get(), *for_stmt->body);
+            }
+            scopes_.pop_back();
+            return flow;
+        } else if (auto* ret = dynamic_cast<ReturnStmt*>(&stmt)) {
+            return_value_ = Value();
+            if (ret->value && !eval(*ret->value, return_value_)) {
+                return Flow::Fail;
+            }
+            return Flow::Return;
+        } else if (dynamic_cast<BreakStmt*>(&stmt)) {
+            return Flow::Break;
+        } else if (dynamic_cast<ContinueStmt*>(&stmt)) {
+            return Flow::Continue;
+        } else if (auto* expr_stmt = dynamic_cast<ExprStmt*>(&stmt)) {
+            if (!expr_stmt->expression) {
+                return Flow::Next;
+            }
+            // A discarded pop() is just a removal; popping nothing does nothing
+            auto* method = dynamic_cast<ListMethodCallExpr*>(expr_stmt->expression.get());
+            if (method && method->method_name == "pop" && method->arguments.empty()) {
+                std::shared_ptr<std::vector<int64_t>> list;
+                if (!eval_list(*method->list, list)) {
+                    return Flow::Fail;
+                }
+                if (!list->empty()) {
+                    list->pop_back();
+                }
+                return Flow::Next;
+            }
+            Value ignored;
+            return eval(*expr_stmt->expression, ignored) ? Flow::Next : Flow::Fail;
+        }
+        // Switch falls through every case at run time; not modelled
+        return Flow::Fail;
+    }
+
+    Flow exec_loop(Expr* condition, Expr* update, Stmt& body) {
+        while (true) {
+            bool keep_going = true;
+            if (!step() || (condition && !eval_bool(*condition, keep_going))) {
+                return Flow::Fail;
+            }
+            if (!keep_going) {
+                return Flow::Next;
+            }
+            Flow flow = exec(body);
+            if (flow == Flow::Break) {
+                return Flow::Next;
+            }
+            if (flow == Flow::Return || flow == Flow::Fail) {
+                return flow;
+            }
+            Value ignored;
+            if (update && !eval(*update, ignored)) {
+                return Flow::Fail;
+            }
+        }
+    }
+};
+
+class ConstantFolder {
+public:
+    size_t folded = 0;
+
+    explicit ConstantFolder(const std::map<std::string, FuncDecl*>& const_functions)
+        : const_functions_(const_functions) {}
+
+    void fold(std::unique_ptr<Expr>& slot) {
+        Expr* expr = slot.get();
+        if (!expr) {
+            return;
+        }
+
+        std::unique_ptr<Expr> replacement;
+        if (auto* binary = dynamic_cast<BinaryExpr*>(expr)) {
+            fold(binary->left);
+            fold(binary->right);
+            // `x = 1 + 2` keeps its target
+            if (!is_assignment_operator(binary->op)) {
+                replacement = fold_binary(*binary);
+            }
+        } else if (auto* unary = dynamic_cast<UnaryExpr*>(expr)) {
+            fold(unary->operand);
+            replacement = fold_unary(*unary);
+        } else if (auto* call = dynamic_cast<CallExpr*>(expr)) {
+            for (auto& arg : call->arguments) {
+                fold(arg);
+            }
+            replacement = fold_call(*call);
+        } else if (auto* access = dynamic_cast<StructAccessExpr*>(expr)) {
+            fold(access->object);
+        } else if (auto* list = dynamic_cast<ListLiteralExpr*>(expr)) {
+            for (auto& element : list->elements) {
+                fold(element);
+            }
+        } else if (auto* index = dynamic_cast<ListIndexExpr*>(expr)) {
+            fold(index->list);
+            fold(index->index);
+        } else if (auto* method = dynamic_cast<ListMethodCallExpr*>(expr)) {
+            fold(method->list);
+            for (auto& arg : method->arguments) {
+                fold(arg);
+            }
+        }
+
+        if (replacement) {
+            slot = std::move(replacement);
+            ++folded;
+        }
+    }
+
+    void fold(Stmt* stmt) {
+        if (!stmt) {
+            return;
+        }
+
+        if (auto* var = dynamic_cast<VarDecl*>(stmt)) {
+            fold(var->initializer);
+        } else if (auto* block = dynamic_cast<BlockStmt*>(stmt)) {
+            for (auto& child : block->statements) {
+                fold(child.get());
+            }
+        } else if (auto* if_stmt = dynamic_cast<IfStmt*>(stmt)) {
+            fold(if_stmt->condition);
+            fold(if_stmt->then_branch.get());
+            fold(if_stmt->else_branch.get());
+        } else if (auto* while_stmt = dynamic_cast<WhileStmt*>(stmt)) {
+            fold(while_stmt->condition);
+            fold(while_stmt->body.get());
+        } else if (auto* for_stmt = dynamic_cast<ForStmt*>(stmt)) {
+            fold(for_stmt->init.get());
+            fold(for_stmt->condition);
+            fold(for_stmt->update);
+            fold(for_stmt->body.get());
+        } else if (auto* switch_stmt = dynamic_cast<SwitchStmt*>(stmt)) {
+            fold(switch_stmt->expression);
+            for (auto& case_stmt : switch_stmt->cases) {
+                fold(case_stmt.get());
+            }
+        } else if (auto* case_stmt = dynamic_cast<CaseStmt*>(stmt)) {
+            fold(case_stmt->value);
+            for (auto& child : case_stmt->statements) {
+                fold(child.get());
+            }
+        } else if (auto* ret = dynamic_cast<ReturnStmt*>(stmt)) {
+            fold(ret->value);
+        } else if (auto* expr_stmt = dynamic_cast<ExprStmt*>(stmt)) {
+            fold(expr_stmt->expression);
+        }
+    }
+
+private:
+    const std::map<std::string, FuncDecl*>& const_functions_;
+    const std::map<std::string, Value> no_globals_;
+
+    // A const function called with constant arguments is run right here
+    std::unique_ptr<Expr> fold_call(CallExpr& call) {
+        auto callee = const_functions_.find(call.function_name);
+        if (callee == const_functions_.end() || callee->second->return_type == "void") {
+            return nullptr;
+        }
+        for (const auto& arg : call.arguments) {
+            if (!is_literal_tree(arg.get())) {
+                return nullptr;
+            }
+        }
+        Interpreter interpreter(const_functions_, no_globals_);
+        Value result;
+        return interpreter.evaluate(call, result) ? make_literal(result, call.position) : nullptr;
+    }
+};
+
+// Run global initializers at compile time in declaration order, up to the
+// first one that needs the program itself. That one and all later ones keep
+// their code, which still runs at startup in the same order, so nothing they
+// see changes.
+size_t evaluate_globals(Program& program, const std::map<std::string, FuncDecl*>& const_functions) {
+    std::map<std::string, Value> values;
+    std::vector<VarDecl*> evaluated;
+    for (auto& global : program.globals) {
+        if (!global->initializer) {
+            continue;
+        }
+
+        // A failed initializer may have changed lists of earlier globals
+        std::vector<std::pair<std::shared_ptr<std::vector<int64_t>>, std::vector<int64_t>>> saved;
+        for (const auto& entry : values) {
+            if (entry.second.list) {
+                saved.emplace_back(entry.second.list, *entry.second.list);
+            }
+        }
+
+        Interpreter interpreter(const_functions, values);
+        Value value;
+        bool ok = interpreter.evaluate(*global->initializer, value) && make_literal(value, global->position);
+        // Two globals holding one list cannot be written out as two literals
+        for (const auto& entry : values) {
+            ok = ok && !(value.list && entry.second.list == value.list);
+        }
+        if (!ok) {
+            for (auto& list : saved) {
+                *list.first = std::move(list.second);
+            }
+            break;
+        }
+        values[global->name] = value;
+        evaluated.push_back(global.get());
+    }
+
+    // Later initializers may have grown earlier lists, so write out the final values
+    size_t replaced = 0;
+    for (VarDecl* global : evaluated) {
+        if (!is_literal_tree(global->initializer.get())) {
+            ++replaced;
+        }
+        global->initializer = make_literal(values[global->name], global->position);
+    }
+    return replaced;
+}
+
+// Which globals appear anywhere other than as the list in `g[i]`, `g.size()` or `g.copy()`
+class GlobalWrites {
+public:
+    std::set<std::string> names;
+
+    void visit(Expr* expr, bool read_only = false) {
+        if (!expr) {
+            return;
+        }
+        if (auto* identifier = dynamic_cast<IdentifierExpr*>(expr)) {
+            if (!read_only) {
+                names.insert(identifier->name);
+            }
+        } else if (auto* index = dynamic_cast<ListIndexExpr*>(expr)) {
+            visit(index->list.get(), true);
+            visit(index->index.get());
+        } else if (auto* method = dynamic_cast<ListMethodCallExpr*>(expr)) {
+            visit(method->list.get(), method->method_name == "size" || method->method_name == "copy");
+            for (auto& arg : method->arguments) {
+                visit(arg.get());
+            }
+        } else if (auto* binary = dynamic_cast<BinaryExpr*>(expr)) {
+            if (is_assignment_operator(binary->op)) {
+                visit_target(binary->left.get());
+            } else {
+                visit(binary->left.get());
+            }
+            visit(binary->right.get());
+        } else if (auto* unary = dynamic_cast<UnaryExpr*>(expr)) {
+            visit(unary->operand.get());
+        } else if (auto* call = dynamic_cast<CallExpr*>(expr)) {
+            for (auto& arg : call->arguments) {
+                visit(arg.get());
+            }
+        } else if (auto* access = dynamic_cast<StructAccessExpr*>(expr)) {
+            visit(access->object.get());
+        } else if (auto* list = dynamic_cast<ListLiteralExpr*>(expr)) {
+            for (auto& element : list->elements) {
+                visit(element.get());
+            }
+        } else if (auto* pre_inc = dynamic_cast<PreIncrementExpr*>(expr)) {
+            visit_target(pre_inc->operand.get());
+        } else if (auto* post_inc = dynamic_cast<PostIncrementExpr*>(expr)) {
+            visit_target(post_inc->operand.get());
+        }
+    }
+
+    // `g[i] = v` and `g[i]++` write the list even though they index it
+    void visit_target(Expr* expr) {
+        if (auto* index = dynamic_cast<ListIndexExpr*>(expr)) {
+            visit(index->list.get());
+            visit(index->index.get());
+        } else {
+            visit(expr);
+        }
+    }
+
+    void visit(Stmt* stmt) {
+        if (auto* var = dynamic_cast<VarDecl*>(stmt)) {
+            visit(var->initializer.get());
+        } else if (auto* block = dynamic_cast<BlockStmt*>(stmt)) {
+            for (auto& child : block->statements) {
+                visit(child.get());
+            }
+        } else if (auto* if_stmt = dynamic_cast<IfStmt*>(stmt)) {
+            visit(if_stmt->condition.get());
+            visit(if_stmt->then_branch.get());
+            visit(if_stmt->else_branch.get());
+        } else if (auto* while_stmt = dynamic_cast<WhileStmt*>(stmt)) {
+            visit(while_stmt->condition.get());
+            visit(while_stmt->body.get());
+        } else if (auto* for_stmt = dynamic_cast<ForStmt*>(stmt)) {
+            visit(for_stmt->init.get());
+            visit(for_stmt->condition.get());
+            visit(for_stmt->update.get());
+            visit(for_stmt->body.get());
+        } else if (auto* switch_stmt = dynamic_cast<SwitchStmt*>(stmt)) {
+            visit(switch_stmt->expression.get());
+            for (auto& case_stmt : switch_stmt->cases) {
+                visit(case_stmt.get());
+            }
+        } else if (auto* case_stmt = dynamic_cast<CaseStmt*>(stmt)) {
+            visit(case_stmt->value.get());
+            for (auto& child : case_stmt->statements) {
+                visit(child.get());
+            }
+        } else if (auto* ret = dynamic_cast<ReturnStmt*>(stmt)) {
+            visit(ret->value.get());
+        } else if (auto* expr_stmt = dynamic_cast<ExprStmt*>(stmt)) {
+            visit(expr_stmt->expression.get());
+        }
+    }
+};
+
+// Global int lists with a literal value that nothing can change can be laid
+// out as read-only data instead of being built at startup
+void mark_constant_data(Program& program) {
+    GlobalWrites writes;
+    for (auto& global : program.globals) {
+        writes.visit(global.get());
+    }
+    for (auto& func : program.functions) {
+        writes.visit(func->body.get());
+    }
+    for (auto& global : program.globals) {
+        global->constant_data = global->type == "list<int>" && !writes.names.count(global->name) &&
+                                dynamic_cast<ListLiteralExpr*>(global->initializer.get()) &&
+                                is_literal_tree(global->initializer.get());
+    }
+}
+
+} // namespace
+
+size_t fold_constants(Program& program) {
+    std::map<std::string, FuncDecl*> const_functions;
+    for (auto& func : program.functions) {
+        if (func->is_const && func->body) {
+            const_functions[func->name] = func.get();
+        }
+    }
+
+    ConstantFolder folder(const_functions);
+    for (auto& global : program.globals) {
+        folder.fold(global.get());
+    }
+    for (auto& func : program.functions) {
+        folder.fold(func->body.get());
+    }
+
+    size_t folded = folder.folded + evaluate_globals(program, const_functions);
+    mark_constant_data(program);
+    return folded;
+}
+
+} // namespace ris
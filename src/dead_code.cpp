@@ -0,0 +1,192 @@
+#include "dead_code.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ris {
+
+namespace {
+
+// Collects the functions called and the names used by code, and whether
+// running that code can be observed
+class UseCollector {
+public:
+    explicit UseCollector(const std::map<std::string, const FuncDecl*>& definitions) : definitions_(definitions) {}
+
+    std::set<std::string> calls;
+    std::set<std::string> names;
+    bool side_effects = false;
+
+    void visit(const Expr* expr) {
+        if (!expr) {
+            return;
+        }
+
+        if (auto* identifier = dynamic_cast<const IdentifierExpr*>(expr)) {
+            names.insert(identifier->name);
+        } else if (auto* binary = dynamic_cast<const BinaryExpr*>(expr)) {
+            side_effects = side_effects || is_assignment_operator(binary->op);
+            visit(binary->left.get());
+            visit(binary->right.get());
+        } else if (auto* unary = dynamic_cast<const UnaryExpr*>(expr)) {
+            visit(unary->operand.get());
+        } else if (auto* call = dynamic_cast<const CallExpr*>(expr)) {
+            calls.insert(call->function_name);
+            note_call(call->function_name);
+            for (const auto& arg : call->arguments) {
+                visit(arg.get());
+            }
+        } else if (auto* access = dynamic_cast<const StructAccessExpr*>(expr)) {
+            visit(access->object.get());
+        } else if (auto* list = dynamic_cast<const ListLiteralExpr*>(expr)) {
+            for (const auto& element : list->elements) {
+                visit(element.get());
+            }
+        } else if (auto* index = dynamic_cast<const ListIndexExpr*>(expr)) {
+            visit(index->list.get());
+            visit(index->index.get());
+        } else if (auto* method = dynamic_cast<const ListMethodCallExpr*>(expr)) {
+            side_effects = side_effects || method->method_name != "size";
+            visit(method->list.get());
+            for (const auto& arg : method->arguments) {
+                visit(arg.get());
+            }
+        } else if (auto* pre_inc = dynamic_cast<const PreIncrementExpr*>(expr)) {
+            side_effects = true;
+            visit(pre_inc->operand.get());
+        } else if (auto* post_inc = dynamic_cast<const PostIncrementExpr*>(expr)) {
+            side_effects = true;
+            visit(post_inc->operand.get());
+        }
+    }
+
+    void visit(const Stmt* stmt) {
+        if (auto* var = dynamic_cast<const VarDecl*>(stmt)) {
+            visit(var->initializer.get());
+        } else if (auto* block = dynamic_cast<const BlockStmt*>(stmt)) {
+            for (const auto& child : block->statements) {
+                visit(child.get());
+            }
+        } else if (auto* if_stmt = dynamic_cast<const IfStmt*>(stmt)) {
+            visit(if_stmt->condition.get());
+            visit(if_stmt->then_branch.get());
+            visit(if_stmt->else_branch.get());
+        } else if (auto* while_stmt = dynamic_cast<const WhileStmt*>(stmt)) {
+            visit(while_stmt->condition.get());
+            visit(while_stmt->body.get());
+        } else if (auto* for_stmt = dynamic_cast<const ForStmt*>(stmt)) {
+            visit(for_stmt->init.get());
+            visit(for_stmt->condition.get());
+            visit(for_stmt->update.get());
+            visit(for_stmt->body.get());
+        } else if (auto* switch_stmt = dynamic_cast<const SwitchStmt*>(stmt)) {
+            visit(switch_stmt->expression.get());
+            for (const auto& case_stmt : switch_stmt->cases) {
+                visit(case_stmt.get());
+            }
+        } else if (auto* case_stmt = dynamic_cast<const CaseStmt*>(stmt)) {
+            visit(case_stmt->value.get());
+            for (const auto& child : case_stmt->statements) {
+                visit(child.get());
+            }
+        } else if (auto* ret = dynamic_cast<const ReturnStmt*>(stmt)) {
+            visit(ret->value.get());
+        } else if (auto* expr_stmt = dynamic_cast<const ExprStmt*>(stmt)) {
+            visit(expr_stmt->expression.get());
+        }
+    }
+
+private:
+    const std::map<std::string, const FuncDecl*>& definitions_;
+
+    void note_call(const std::string& name) {
+        if (name == "likely" || name == "unlikely" || name == "ris_string_length") {
+            return;
+        }
+        // Purity is inferred by semantic analysis; runtime calls allocate, print or exit
+        auto definition = definitions_.find(name);
+        if (definition == definitions_.end() || definition->second->purity == FunctionPurity::SideEffects) {
+            side_effects = true;
+        }
+    }
+};
+
+} // namespace
+
+size_t remove_unused_declarations(Program& program) {
+    std::map<std::string, const FuncDecl*> definitions;
+    for (const auto& func : program.functions) {
+        if (func->body) {
+            definitions[func->name] = func.get();
+        }
+    }
+    if (!definitions.count("main")) {
+        return 0;
+    }
+
+    std::map<std::string, const VarDecl*> globals;
+    for (const auto& global : program.globals) {
+        globals[global->name] = global.get();
+    }
+
+    std::set<std::string> used_functions;
+    std::set<std::string> used_globals;
+    std::vector<std::string> pending_functions = {"main"};
+    std::vector<std::string> pending_globals;
+
+    // Initializers that do something observable run whether or not the global is read
+    for (const auto& global : program.globals) {
+        UseCollector uses(definitions);
+        uses.visit(global->initializer.get());
+        if (uses.side_effects) {
+            pending_globals.push_back(global->name);
+        }
+    }
+
+    while (!pending_functions.empty() || !pending_globals.empty()) {
+        UseCollector uses(definitions);
+        if (!pending_functions.empty()) {
+            std::string name = pending_functions.back();
+            pending_functions.pop_back();
+            if (!used_functions.insert(name).second) {
+                continue;
+            }
+            auto definition = definitions.find(name);
+            if (definition != definitions.end()) {
+                uses.visit(definition->second->body.get());
+            }
+        } else {
+            std::string name = pending_globals.back();
+            pending_globals.pop_back();
+            if (!used_globals.insert(name).second) {
+                continue;
+            }
+            uses.visit(globals[name]->initializer.get());
+        }
+
+        pending_functions.insert(pending_functions.end(), uses.calls.begin(), uses.calls.end());
+        // A local may share a global's name; keeping the global is merely conservative
+        for (const auto& name : uses.names) {
+            if (globals.count(name)) {
+                pending_globals.push_back(name);
+            }
+        }
+    }
+
+    size_t before = program.functions.size() + program.globals.size();
+    program.functions.erase(std::remove_if(program.functions.begin(), program.functions.end(),
+                                           [&](const std::unique_ptr<FuncDecl>& func) {
+                                               return !used_functions.count(func->name);
+                                           }),
+                            program.functions.end());
+    program.globals.erase(std::remove_if(program.globals.begin(), program.globals.end(),
+                                         [&](const std::unique_ptr<VarDecl>& global) {
+                                             return !used_globals.count(global->name);
+                                         }),
+                          program.globals.end());
+    return before - program.functions.size() - program.globals.size();
+}
+
+} // namespace ris
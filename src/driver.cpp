@@ -0,0 +1,474 @@
+#include "driver.h"
+#include "cache.h"
+#include "constant_folding.h"
+#include "dead_code.h"
+#include "escape_analysis.h"
+#include "lexer.h"
+#include "module_build.h"
+#include "parser.h"
+#include "semantic_analyzer.h"
+#include "tail_recursion.h"
+#include "thread_pool.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace ris {
+
+namespace {
+
+// Create a private directory for one job's intermediate files. mkdtemp picks
+// a unique name, so concurrent risc processes in one directory never collide.
+std::string make_temp_dir() {
+    std::error_code ec;
+    std::filesystem::path base = std::filesystem::temp_directory_path(ec);
+    if (ec) {
+        base = "/tmp";
+    }
+
+    std::string pattern = (base / "risc-XXXXXX").string();
+    if (mkdtemp(&pattern[0]) == nullptr) {
+        return "";
+    }
+    return pattern;
+}
+
+std::string derive_output_name(const std::string& input_file) {
+    return std::filesystem::path(input_file).stem().string();
+}
+
+} // namespace
+
+LinkOptions link_options(const DriverOptions& options) {
+    LinkOptions link;
+    link.static_link = options.static_link;
+    link.pie = options.pie;
+    link.verbose = options.verbose;
+    return link;
+}
+
+std::string resolve_path(const std::string& path, const std::string& working_dir) {
+    if (working_dir.empty() || std::filesystem::path(path).is_absolute()) {
+        return path;
+    }
+    return (std::filesystem::path(working_dir) / path).string();
+}
+
+std::string executable_path(const CompileJob& job, const std::string& working_dir) {
+    std::string output_file = job.output_file.empty() ? derive_output_name(job.input_file) : job.output_file;
+    std::string path = resolve_path(output_file, working_dir);
+    #ifdef _WIN32
+        path += ".exe";
+    #endif
+    return path;
+}
+
+CompileResult compile_file(const CompileJob& job, const DriverOptions& options) {
+    CompileResult result;
+    std::ostringstream log;
+    std::ostringstream errors;
+
+    auto finish = [&](bool ok) {
+        result.ok = ok;
+        result.log = log.str();
+        result.errors = errors.str();
+        return result;
+    };
+
+    std::string output_file = job.output_file.empty() ? derive_output_name(job.input_file) : job.output_file;
+
+    // Check that input file has .ris extension
+    std::filesystem::path input_path(job.input_file);
+    if (input_path.extension() != ".ris") {
+        errors << "Error: Input file must have .ris extension, got: " << job.input_file << std::endl;
+        return finish(false);
+    }
+
+    if (options.verbose) {
+        log << "Input file: " << job.input_file << std::endl;
+        log << "Output file: " << output_file << std::endl;
+    }
+
+    // Read input file
+    std::ifstream file(resolve_path(job.input_file, options.working_dir));
+    if (!file.is_open()) {
+        errors << "Error: Could not open input file " << job.input_file << std::endl;
+        return finish(false);
+    }
+
+    std::string source((std::istreambuf_iterator<char>(file)),
+                      std::istreambuf_iterator<char>());
+    file.close();
+
+    // Get the directory of the source file
+    std::string source_dir = std::filesystem::path(resolve_path(job.input_file, options.working_dir)).parent_path().string();
+    if (source_dir.empty()) {
+        source_dir = ".";
+    }
+
+    // Tokenize the source
+    Lexer lexer(source, source_dir);
+    auto tokens = lexer.tokenize();
+
+    if (lexer.has_error()) {
+        errors << "Lexer error: " << lexer.error_message() << std::endl;
+        return finish(false);
+    }
+
+    // Check if std library is included
+    bool needs_std_lib = lexer.includes_std();
+
+    if (options.verbose) {
+        log << "Tokenized " << tokens.size() << " tokens" << std::endl;
+        if (needs_std_lib) {
+            log << "Std library will be linked (found #include <std>)" << std::endl;
+        } else {
+            log << "Std library will NOT be linked (no #include <std> found)" << std::endl;
+        }
+    }
+
+    std::string std_lib = resolve_path("runtime/std.a", options.working_dir);
+    std::string final_output = executable_path(job, options.working_dir);
+
+    // Executables are looked up by everything that goes into them; a hit skips the rest of the pipeline
+    CompileCache cache(job.emit_llvm ? "" : options.cache_dir);
+    std::string key;
+    if (!cache.directory().empty()) {
+        CacheKey cache_key;
+        cache_key.add(CompileCache::compiler_version());
+        cache_key.add("opt " + std::to_string(options.codegen.opt_level));
+        cache_key.add(options.codegen.whole_program ? "whole-program" : "per-function");
+        cache_key.add(options.tail_loops ? "tail-loops" : "tail-calls");
+        cache_key.add(CodeGenerator::arithmetic_mode(options.codegen));
+        cache_key.add(options.static_link ? "static" : options.pie ? "pie" : "no-pie");
+        std::string cpu, features;
+        CodeGenerator::resolve_target(options.codegen, cpu, features);
+        cache_key.add("cpu " + cpu + " " + features);
+        cache_key.add(needs_std_lib ? "std" : "nostd");
+        if (needs_std_lib) {
+            cache_key.add_file(std_lib);
+        }
+        cache_key.add_tokens(tokens);
+        key = cache_key.digest();
+    }
+
+    if (cache.fetch(key, final_output)) {
+        if (options.verbose) {
+            log << "Using cached executable " << key << " from " << cache.directory() << std::endl;
+        }
+        result.output_file = final_output;
+        return finish(true);
+    }
+
+    // Parse the tokens into AST
+    Parser parser(tokens);
+    auto program = parser.parse();
+
+    if (parser.has_error()) {
+        errors << "Parser error: " << parser.error_message() << std::endl;
+        return finish(false);
+    }
+
+    if (options.verbose) {
+        log << "Parsed successfully!" << std::endl;
+        log << "Functions: " << program->functions.size() << std::endl;
+        log << "Global variables: " << program->globals.size() << std::endl;
+    }
+
+    // Perform semantic analysis
+    SemanticAnalyzer analyzer;
+    analyzer.set_jobs(options.sema_jobs);
+    if (!analyzer.analyze(*program)) {
+        errors << "Semantic analysis failed:" << std::endl;
+        for (const auto& error : analyzer.errors()) {
+            errors << "  " << error << std::endl;
+        }
+        return finish(false);
+    }
+
+    if (options.verbose) {
+        log << "Semantic analysis passed!" << std::endl;
+    }
+
+    size_t folded = fold_constants(*program);
+    if (options.verbose) {
+        log << "Folded " << folded << " constant expression(s)" << std::endl;
+    }
+
+    // After folding, so calls it replaced no longer keep their callees alive
+    size_t removed = remove_unused_declarations(*program);
+    if (options.verbose) {
+        log << "Removed " << removed << " unused function(s) and global(s)" << std::endl;
+    }
+
+    if (options.tail_loops) {
+        size_t rewritten = rewrite_tail_recursion(*program);
+        if (options.verbose) {
+            log << "Tail recursion turned into loops in " << rewritten << " function(s)" << std::endl;
+        }
+    }
+
+    // Last, so it sees the loops tail recursion became
+    size_t stack_lists = mark_stack_lists(*program);
+    if (options.verbose) {
+        log << "Placed " << stack_lists << " list(s) on the stack" << std::endl;
+    }
+
+    CodeGenerator codegen(options.codegen);
+
+    if (job.emit_llvm) {
+        // Ensure out directory exists for generated files
+        std::error_code ec;
+        std::filesystem::create_directories(resolve_path("out", options.working_dir), ec);
+
+        // Generate LLVM IR
+        std::string llvm_output = resolve_path("out/" + output_file, options.working_dir);
+        if (!codegen.generate(std::move(program), llvm_output)) {
+            errors << "Code generation failed: " << codegen.error_message() << std::endl;
+            return finish(false);
+        }
+
+        if (options.verbose) {
+            log << "Code generation completed! Output written to " << output_file << std::endl;
+        }
+        result.output_file = llvm_output;
+        return finish(true);
+    }
+
+    std::string temp_dir = make_temp_dir();
+    if (temp_dir.empty()) {
+        errors << "Error: Could not create a temporary directory" << std::endl;
+        return finish(false);
+    }
+
+    auto remove_temp_dir = [&temp_dir]() {
+        std::error_code ec;
+        std::filesystem::remove_all(temp_dir, ec);
+    };
+
+    if (options.verbose) {
+        log << "Compiling to object code with " << options.codegen.jobs << " job(s) in " << temp_dir << "..." << std::endl;
+    }
+
+    // Step 1: Generate, optimize and emit native objects in-process
+    std::vector<std::string> object_files;
+    std::string object_prefix = (std::filesystem::path(temp_dir) / derive_output_name(job.input_file)).string();
+    if (!codegen.generate_objects(std::move(program), object_prefix, object_files)) {
+        errors << "Code generation failed: " << codegen.error_message() << std::endl;
+        remove_temp_dir();
+        return finish(false);
+    }
+
+    // Step 2: Link the objects with the runtime library (if needed)
+    bool linked = link_executable(object_files, needs_std_lib ? std_lib : "", final_output,
+                                  link_options(options), log, errors);
+    remove_temp_dir();
+    if (!linked) {
+        return finish(false);
+    }
+
+    cache.store(key, final_output);
+
+    if (options.verbose) {
+        log << "Executable created: " << output_file << std::endl;
+    }
+
+    result.output_file = final_output;
+    return finish(true);
+}
+
+std::vector<CompileResult> compile_files(const std::vector<CompileJob>& jobs, const DriverOptions& options) {
+    std::vector<CompileResult> results(jobs.size());
+    if (jobs.size() == 1) {
+        results[0] = compile_file(jobs[0], options);
+        return results;
+    }
+
+    // With many files the parallelism comes from the pool; keep each file single-threaded
+    DriverOptions per_file = options;
+    per_file.codegen.jobs = 1;
+    per_file.sema_jobs = 1;
+
+    parallel_for(jobs.size(), options.jobs, [&](size_t i) {
+        results[i] = compile_file(jobs[i], per_file);
+    });
+    return results;
+}
+
+bool parse_arguments(const std::vector<std::string>& args, const std::string& working_dir,
+                     Invocation& invocation, std::string& error) {
+    std::string output_file;
+    std::string manifest_file;
+    unsigned jobs = 0;
+    bool use_cache = true;
+
+    invocation.options.working_dir = working_dir;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        if (i == 0 && arg == "build") {
+            invocation.build_modules = true;
+        } else if ((arg == "-j" && i + 1 < args.size()) || (arg.size() > 2 && arg.compare(0, 2, "-j") == 0)) {
+            std::string count = arg == "-j" ? args[++i] : arg.substr(2);
+            jobs = static_cast<unsigned>(std::strtoul(count.c_str(), nullptr, 10));
+            if (jobs == 0) {
+                error = "-j expects a positive number of jobs, got: " + count;
+                return false;
+            }
+        } else if (arg == "-o" && i + 1 < args.size()) {
+            output_file = args[++i];
+        } else if (arg == "--batch" && i + 1 < args.size()) {
+            manifest_file = args[++i];
+        } else if (arg == "--socket" && i + 1 < args.size()) {
+            invocation.socket_path = args[++i];
+        } else if (arg == "--server") {
+            invocation.start_server = true;
+        } else if (arg == "--connect") {
+            invocation.use_server = true;
+        } else if (arg == "--static") {
+            invocation.options.static_link = true;
+        } else if (arg == "--no-pie") {
+            invocation.options.pie = false;
+        } else if (arg.compare(0, 13, "--target-cpu=") == 0) {
+            invocation.options.codegen.target_cpu = arg.substr(13);
+        } else if (arg.compare(0, 18, "--target-features=") == 0) {
+            invocation.options.codegen.target_features = arg.substr(18);
+        } else if (arg == "-march=native") {
+            invocation.options.codegen.target_cpu = "native";
+        } else if (arg == "--no-whole-program") {
+            invocation.options.codegen.whole_program = false;
+        } else if (arg == "--tail-loops") {
+            invocation.options.tail_loops = true;
+        } else if (arg == "--fast-math") {
+            invocation.options.codegen.fast_math = true;
+        } else if (arg == "--fp-contract") {
+            invocation.options.codegen.fp_contract = true;
+        } else if (arg == "--reassoc") {
+            invocation.options.codegen.reassoc = true;
+        } else if (arg == "--no-signed-wrap") {
+            invocation.options.codegen.no_signed_wrap = true;
+        } else if (arg == "--no-cache") {
+            use_cache = false;
+        } else if (arg == "--run") {
+            invocation.auto_run = true;
+        } else if (arg == "--verbose") {
+            invocation.options.verbose = true;
+        } else if (arg == "-o" || arg == "-j" || arg == "--batch" || arg == "--socket") {
+            error = arg + " expects a value";
+            return false;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            // A misspelled or incomplete option is not a file to compile
+            error = "unknown option: " + arg;
+            return false;
+        } else {
+            // Every non-flag argument is an input file
+            CompileJob job;
+            job.input_file = arg;
+            invocation.jobs.push_back(job);
+        }
+    }
+
+    // Position-dependent executables can use position-dependent code
+    invocation.options.codegen.pic = invocation.options.pie && !invocation.options.static_link;
+
+    if (use_cache) {
+        invocation.options.cache_dir = CompileCache::default_directory();
+    }
+
+    if (!manifest_file.empty()) {
+        std::vector<CompileJob> manifest_jobs;
+        if (!read_manifest(resolve_path(manifest_file, working_dir), manifest_jobs, error)) {
+            return false;
+        }
+        invocation.jobs.insert(invocation.jobs.begin(), manifest_jobs.begin(), manifest_jobs.end());
+    }
+
+    if (invocation.jobs.size() > 1 && (!output_file.empty() || invocation.auto_run)) {
+        error = "-o and --run can only be used with a single input file";
+        return false;
+    }
+
+    if (!output_file.empty() && !invocation.jobs.empty()) {
+        invocation.jobs[0].output_file = output_file;
+        // Check if output file has .ll extension (LLVM IR instead of an executable)
+        invocation.jobs[0].emit_llvm = output_file.find(".ll") != std::string::npos;
+    }
+
+    if (invocation.build_modules) {
+        // Module units are the unit of parallelism
+        invocation.options.jobs = jobs != 0 ? jobs : ThreadPool::default_jobs();
+        for (const auto& job : invocation.jobs) {
+            if (job.emit_llvm) {
+                error = "risc build produces executables; use risc <input.ris> -o <output.ll> for LLVM IR";
+                return false;
+            }
+        }
+    } else if (invocation.jobs.size() == 1) {
+        // A single file spends the jobs on its own semantic analysis and code generation
+        if (jobs != 0) {
+            invocation.options.codegen.jobs = jobs;
+            invocation.options.sema_jobs = jobs;
+        }
+    } else {
+        invocation.options.jobs = jobs != 0 ? jobs : ThreadPool::default_jobs();
+    }
+
+    return true;
+}
+
+InvocationResult run_invocation(const Invocation& invocation) {
+    InvocationResult result;
+    std::vector<CompileResult> results;
+    if (invocation.build_modules) {
+        for (const auto& job : invocation.jobs) {
+            results.push_back(build_program(job, invocation.options));
+        }
+    } else {
+        results = compile_files(invocation.jobs, invocation.options);
+    }
+
+    for (const auto& compiled : results) {
+        result.log += compiled.log;
+        result.errors += compiled.errors;
+        result.output_files.push_back(compiled.ok ? compiled.output_file : "");
+        if (!compiled.ok) {
+            result.exit_code = 1;
+        }
+    }
+    return result;
+}
+
+bool read_manifest(const std::string& path, std::vector<CompileJob>& jobs, std::string& error) {
+    std::ifstream manifest(path);
+    if (!manifest.is_open()) {
+        error = "Could not open batch manifest " + path;
+        return false;
+    }
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(manifest, line)) {
+        line_number++;
+
+        std::istringstream fields(line);
+        CompileJob job;
+        if (!(fields >> job.input_file) || job.input_file[0] == '#') {
+            continue;
+        }
+        fields >> job.output_file;
+
+        std::string extra;
+        if (fields >> extra) {
+            error = path + ":" + std::to_string(line_number) + ": expected '<input.ris> [output]', got: " + line;
+            return false;
+        }
+
+        job.emit_llvm = job.output_file.find(".ll") != std::string::npos;
+        jobs.push_back(job);
+    }
+
+    return true;
+}
+
+} // namespace ris
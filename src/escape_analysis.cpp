@@ -0,0 +1,160 @@
+#include "escape_analysis.h"
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ris {
+
+namespace {
+
+// Collects the names whose value may outlive one function's use of it, and
+// the locals a list literal initializes
+class EscapeFinder {
+public:
+    std::set<std::string> escaping;
+    std::vector<VarDecl*> candidates;
+
+    // Anywhere else, a value named here may be kept
+    void visit(Expr* expr) {
+        if (!expr) {
+            return;
+        }
+
+        if (auto* identifier = dynamic_cast<IdentifierExpr*>(expr)) {
+            escaping.insert(identifier->name);
+        } else if (auto* binary = dynamic_cast<BinaryExpr*>(expr)) {
+            if (is_assignment_operator(binary->op)) {
+                visit_target(binary->left.get());
+                visit(binary->right.get());
+            } else if (binary->op == TokenType::EQUAL || binary->op == TokenType::NOT_EQUAL) {
+                visit_list(binary->left.get());
+                visit_list(binary->right.get());
+            } else {
+                visit(binary->left.get());
+                visit(binary->right.get());
+            }
+        } else if (auto* unary = dynamic_cast<UnaryExpr*>(expr)) {
+            visit(unary->operand.get());
+        } else if (auto* call = dynamic_cast<CallExpr*>(expr)) {
+            // print only reads its argument; any other callee may keep it
+            bool reads_only = call->function_name == "print" || call->function_name == "println";
+            for (auto& arg : call->arguments) {
+                if (reads_only) {
+                    visit_list(arg.get());
+                } else {
+                    visit(arg.get());
+                }
+            }
+        } else if (auto* access = dynamic_cast<StructAccessExpr*>(expr)) {
+            visit(access->object.get());
+        } else if (auto* list = dynamic_cast<ListLiteralExpr*>(expr)) {
+            for (auto& element : list->elements) {
+                visit(element.get());
+            }
+        } else if (auto* index = dynamic_cast<ListIndexExpr*>(expr)) {
+            visit_list(index->list.get());
+            visit(index->index.get());
+        } else if (auto* method = dynamic_cast<ListMethodCallExpr*>(expr)) {
+            // extend copies the elements of its argument, not the list
+            visit_list(method->list.get());
+            for (auto& arg : method->arguments) {
+                if (method->method_name == "extend") {
+                    visit_list(arg.get());
+                } else {
+                    visit(arg.get());
+                }
+            }
+        } else if (auto* pre_inc = dynamic_cast<PreIncrementExpr*>(expr)) {
+            visit_target(pre_inc->operand.get());
+        } else if (auto* post_inc = dynamic_cast<PostIncrementExpr*>(expr)) {
+            visit_target(post_inc->operand.get());
+        }
+    }
+
+    void visit(Stmt* stmt) {
+        if (auto* var = dynamic_cast<VarDecl*>(stmt)) {
+            if (dynamic_cast<ListLiteralExpr*>(var->initializer.get())) {
+                candidates.push_back(var);
+            }
+            visit(var->initializer.get());
+        } else if (auto* block = dynamic_cast<BlockStmt*>(stmt)) {
+            for (auto& child : block->statements) {
+                visit(child.get());
+            }
+        } else if (auto* if_stmt = dynamic_cast<IfStmt*>(stmt)) {
+            visit(if_stmt->condition.get());
+            visit(if_stmt->then_branch.get());
+            visit(if_stmt->else_branch.get());
+        } else if (auto* while_stmt = dynamic_cast<WhileStmt*>(stmt)) {
+            visit(while_stmt->condition.get());
+            visit(while_stmt->body.get());
+        } else if (auto* for_stmt = dynamic_cast<ForStmt*>(stmt)) {
+            visit(for_stmt->init.get());
+            visit(for_stmt->condition.get());
+            visit(for_stmt->update.get());
+            visit(for_stmt->body.get());
+        } else if (auto* switch_stmt = dynamic_cast<SwitchStmt*>(stmt)) {
+            visit(switch_stmt->expression.get());
+            for (auto& case_stmt : switch_stmt->cases) {
+                visit(case_stmt.get());
+            }
+        } else if (auto* case_stmt = dynamic_cast<CaseStmt*>(stmt)) {
+            visit(case_stmt->value.get());
+            for (auto& child : case_stmt->statements) {
+                visit(child.get());
+            }
+        } else if (auto* ret = dynamic_cast<ReturnStmt*>(stmt)) {
+            // The code generator may make a call here a tail call, which
+            // promises the callee never touches the caller's frame
+            returning_ = true;
+            visit(ret->value.get());
+            returning_ = false;
+        } else if (auto* expr_stmt = dynamic_cast<ExprStmt*>(stmt)) {
+            visit(expr_stmt->expression.get());
+        }
+    }
+
+private:
+    bool returning_ = false;
+
+    // The list itself is only read or updated in place here
+    void visit_list(Expr* expr) {
+        if (returning_ || !dynamic_cast<IdentifierExpr*>(expr)) {
+            visit(expr);
+        }
+    }
+
+    // `xs = e` replaces what xs holds and `xs[i] = e` writes an element;
+    // neither lets the old list escape
+    void visit_target(Expr* expr) {
+        if (auto* index = dynamic_cast<ListIndexExpr*>(expr)) {
+            visit_list(index->list.get());
+            visit(index->index.get());
+        } else {
+            visit_list(expr);
+        }
+    }
+};
+
+} // namespace
+
+size_t mark_stack_lists(Program& program) {
+    size_t marked = 0;
+    for (auto& func : program.functions) {
+        if (!func->body) {
+            continue;
+        }
+
+        EscapeFinder finder;
+        finder.visit(func->body.get());
+        for (auto* var : finder.candidates) {
+            if (!finder.escaping.count(var->name)) {
+                static_cast<ListLiteralExpr*>(var->initializer.get())->stack_allocated = true;
+                ++marked;
+            }
+        }
+    }
+    return marked;
+}
+
+} // namespace ris
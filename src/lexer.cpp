@@ -57,7 +57,7 @@ Token Lexer::next_token() {
     }
     
     // Punctuation
-    if (c == ';' || c == ',' || c == '.' || c == ':' ||
+    if (c == ';' || c == ',' || c == '.' || c == ':' || c == '@' ||
         c == '(' || c == ')' || c == '{' || c == '}' ||
         c == '[' || c == ']') {
         return scan_punctuation();
@@ -97,7 +97,17 @@ std::vector<Token> Lexer::tokenize() {
         if (token.type == TokenType::INCLUDE) {
             // Read the included file and tokenize it
             std::string filename = token.value;
-            std::string include_content = read_include_file(filename, source_dir_);
+            included_files_.push_back(include_path(filename, source_dir_));
+            
+            std::string include_content;
+            if (include_reader_) {
+                if (!include_reader_(included_files_.back(), include_content)) {
+                    has_error_ = true;
+                    error_message_ = "Could not read interface of module " + included_files_.back();
+                }
+            } else {
+                include_content = read_include_file(filename, source_dir_);
+            }
             
             if (has_error_) {
                 // Error reading include file, return empty tokens
@@ -315,22 +325,42 @@ Token Lexer::scan_operator() {
                 advance();
                 return Token(TokenType::INCREMENT, "++", start_pos);
             }
+            if (!is_at_end() && current_char() == '=') {
+                advance();
+                return Token(TokenType::PLUS_ASSIGN, "+=", start_pos);
+            }
             return Token(TokenType::PLUS, "+", start_pos);
             
         case '-':
             advance();
+            if (!is_at_end() && current_char() == '=') {
+                advance();
+                return Token(TokenType::MINUS_ASSIGN, "-=", start_pos);
+            }
             return Token(TokenType::MINUS, "-", start_pos);
             
         case '*':
             advance();
+            if (!is_at_end() && current_char() == '=') {
+                advance();
+                return Token(TokenType::MULTIPLY_ASSIGN, "*=", start_pos);
+            }
             return Token(TokenType::MULTIPLY, "*", start_pos);
             
         case '/':
             advance();
+            if (!is_at_end() && current_char() == '=') {
+                advance();
+                return Token(TokenType::DIVIDE_ASSIGN, "/=", start_pos);
+            }
             return Token(TokenType::DIVIDE, "/", start_pos);
             
         case '%':
             advance();
+            if (!is_at_end() && current_char() == '=') {
+                advance();
+                return Token(TokenType::MODULO_ASSIGN, "%=", start_pos);
+            }
             return Token(TokenType::MODULO, "%", start_pos);
             
         case '=':
@@ -427,6 +457,9 @@ Token Lexer::scan_punctuation() {
         case ':':
             advance();
             return Token(TokenType::COLON, ":", start_pos);
+        case '@':
+            advance();
+            return Token(TokenType::AT, "@", start_pos);
         default:
             has_error_ = true;
             error_message_ = "Unexpected character in punctuation scan";
@@ -523,17 +556,19 @@ bool Lexer::is_whitespace(char c) const {
     return c == ' ' || c == '\t' || c == '\r' || c == '\n';
 }
 
-std::string Lexer::read_include_file(const std::string& filename, const std::string& current_dir) {
-    std::string full_path;
-    
+std::string Lexer::include_path(const std::string& filename, const std::string& current_dir) const {
     // If filename starts with /, it's an absolute path
     if (filename[0] == '/') {
-        full_path = filename;
-    } else {
-        // Relative path - combine with current directory
-        full_path = current_dir + "/" + filename;
+        return filename;
     }
     
+    // Relative path - combine with current directory
+    return current_dir + "/" + filename;
+}
+
+std::string Lexer::read_include_file(const std::string& filename, const std::string& current_dir) {
+    std::string full_path = include_path(filename, current_dir);
+    
     std::ifstream file(full_path);
     if (!file.is_open()) {
         has_error_ = true;
@@ -0,0 +1,332 @@
+#include "linker.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef RIS_WITH_LLD
+#include <lld/Common/Driver.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/raw_ostream.h>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#if LLVM_VERSION_MAJOR >= 17
+#include <llvm/TargetParser/Host.h>
+#include <llvm/TargetParser/Triple.h>
+LLD_HAS_DRIVER(elf)
+#else
+#include <lld/Common/CommonLinkerContext.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/Support/Host.h>
+#endif
+#endif
+
+extern char** environ;
+
+namespace ris {
+
+namespace {
+
+#ifdef RIS_WITH_LLD
+
+// Files the compiler driver would normally add around our objects
+struct Toolchain {
+    bool found = false;
+    std::string crt1, scrt1, crti, crtn;
+    std::string crtbegin, crtbegin_shared, crtbegin_static, crtend, crtend_shared;
+    std::vector<std::string> library_dirs;
+    std::string dynamic_linker;
+};
+
+// The directories the compiler driver searches for startup files and
+// libraries, from a single `-print-search-dirs` run
+std::vector<std::string> toolchain_search_dirs() {
+    FILE* pipe = popen("clang++ -print-search-dirs 2>/dev/null", "r");
+    if (!pipe) {
+        return {};
+    }
+
+    std::string output;
+    char buffer[512];
+    while (fgets(buffer, sizeof(buffer), pipe)) {
+        output += buffer;
+    }
+    pclose(pipe);
+
+    // libraries: =/usr/lib/gcc/x86_64-linux-gnu/12/:/usr/lib/x86_64-linux-gnu/:...
+    std::vector<std::string> dirs;
+    std::string prefix = "libraries: ";
+    size_t line = output.find(prefix);
+    if (line == std::string::npos) {
+        return dirs;
+    }
+    size_t begin = line + prefix.size();
+    size_t end = output.find('\n', begin);
+    std::string list = output.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+    if (!list.empty() && list[0] == '=') {
+        list.erase(0, 1);
+    }
+
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t colon = list.find(':', pos);
+        std::string dir = list.substr(pos, colon == std::string::npos ? std::string::npos : colon - pos);
+        if (!dir.empty()) {
+            dirs.push_back(std::filesystem::path(dir).lexically_normal().string());
+        }
+        if (colon == std::string::npos) {
+            break;
+        }
+        pos = colon + 1;
+    }
+    return dirs;
+}
+
+// The first search directory holding `name`, or "" when none does
+std::string toolchain_file(const std::vector<std::string>& dirs, const std::string& name) {
+    std::error_code ec;
+    for (const auto& dir : dirs) {
+        std::filesystem::path path = std::filesystem::path(dir) / name;
+        if (std::filesystem::exists(path, ec)) {
+            return path.lexically_normal().string();
+        }
+    }
+    return "";
+}
+
+Toolchain discover_toolchain() {
+    Toolchain toolchain;
+
+    llvm::Triple host(llvm::sys::getDefaultTargetTriple());
+    if (host.getArch() == llvm::Triple::x86_64) {
+        toolchain.dynamic_linker = "/lib64/ld-linux-x86-64.so.2";
+    } else if (host.getArch() == llvm::Triple::aarch64) {
+        toolchain.dynamic_linker = "/lib/ld-linux-aarch64.so.1";
+    }
+    if (!host.isOSLinux() || toolchain.dynamic_linker.empty()) {
+        return toolchain;
+    }
+
+    std::vector<std::string> dirs = toolchain_search_dirs();
+    toolchain.crt1 = toolchain_file(dirs, "crt1.o");
+    toolchain.scrt1 = toolchain_file(dirs, "Scrt1.o");
+    toolchain.crti = toolchain_file(dirs, "crti.o");
+    toolchain.crtn = toolchain_file(dirs, "crtn.o");
+    toolchain.crtbegin = toolchain_file(dirs, "crtbegin.o");
+    toolchain.crtbegin_shared = toolchain_file(dirs, "crtbeginS.o");
+    toolchain.crtbegin_static = toolchain_file(dirs, "crtbeginT.o");
+    toolchain.crtend = toolchain_file(dirs, "crtend.o");
+    toolchain.crtend_shared = toolchain_file(dirs, "crtendS.o");
+
+    for (const char* library : {"libstdc++.so", "libgcc.a", "libc.so"}) {
+        std::string path = toolchain_file(dirs, library);
+        if (path.empty()) {
+            return toolchain;
+        }
+        toolchain.library_dirs.push_back(std::filesystem::path(path).parent_path().string());
+    }
+
+    toolchain.found = !toolchain.crt1.empty() && !toolchain.scrt1.empty() && !toolchain.crti.empty() &&
+                      !toolchain.crtn.empty() && !toolchain.crtbegin.empty() &&
+                      !toolchain.crtbegin_shared.empty() && !toolchain.crtbegin_static.empty() &&
+                      !toolchain.crtend.empty() && !toolchain.crtend_shared.empty();
+    return toolchain;
+}
+
+// Located once per process; a compile server pays for it on its first link only
+const Toolchain& host_toolchain() {
+    static const Toolchain toolchain = discover_toolchain();
+    return toolchain;
+}
+
+// The same command line the clang++ driver would hand to the linker
+std::vector<std::string> linker_arguments(const Toolchain& toolchain, const std::vector<std::string>& object_files,
+                                          const std::string& runtime_library, const std::string& output_file,
+                                          const LinkOptions& options) {
+    bool pie = options.pie && !options.static_link;
+    std::vector<std::string> args = {"ld.lld", "-o", output_file, "--eh-frame-hdr"};
+
+    if (options.static_link) {
+        args.push_back("-static");
+    } else {
+        args.push_back(pie ? "-pie" : "-no-pie");
+        args.push_back("-dynamic-linker");
+        args.push_back(toolchain.dynamic_linker);
+    }
+
+    args.push_back(pie ? toolchain.scrt1 : toolchain.crt1);
+    args.push_back(toolchain.crti);
+    args.push_back(options.static_link ? toolchain.crtbegin_static : pie ? toolchain.crtbegin_shared : toolchain.crtbegin);
+
+    for (const auto& dir : toolchain.library_dirs) {
+        args.push_back("-L" + dir);
+    }
+
+    args.insert(args.end(), object_files.begin(), object_files.end());
+    if (!runtime_library.empty()) {
+        args.push_back(runtime_library);
+    }
+
+    args.push_back("-lstdc++");
+    args.push_back("-lm");
+    if (options.static_link) {
+        args.push_back("--start-group");
+        args.push_back("-lgcc");
+        args.push_back("-lgcc_eh");
+        args.push_back("-lc");
+        args.push_back("--end-group");
+    } else {
+        args.push_back("-lgcc_s");
+        args.push_back("-lgcc");
+        args.push_back("-lc");
+        args.push_back("-lgcc_s");
+        args.push_back("-lgcc");
+    }
+
+    args.push_back(pie ? toolchain.crtend_shared : toolchain.crtend);
+    args.push_back(toolchain.crtn);
+    return args;
+}
+
+// LLD keeps global state between runs and must not link twice at once
+std::mutex lld_mutex;
+
+bool link_with_lld(const std::vector<std::string>& args, std::ostream& errors) {
+    std::vector<const char*> argv;
+    for (const auto& arg : args) {
+        argv.push_back(arg.c_str());
+    }
+
+    std::string diagnostics;
+    llvm::raw_string_ostream diagnostics_stream(diagnostics);
+
+    std::lock_guard<std::mutex> lock(lld_mutex);
+#if LLVM_VERSION_MAJOR >= 17
+    lld::Result result = lld::lldMain(argv, llvm::nulls(), diagnostics_stream, {{lld::Gnu, &lld::elf::link}});
+    bool ok = result.retCode == 0;
+#else
+    // Before LLVM 17 the caller owns the context each link creates; lldMain frees it from 17 on
+    bool ok = lld::elf::link(argv, llvm::nulls(), diagnostics_stream, /*exitEarly=*/false, /*disableOutput=*/false);
+    lld::CommonLinkerContext::destroy();
+#endif
+
+    diagnostics_stream.flush();
+    if (!ok) {
+        errors << diagnostics;
+        errors << "Error: lld linking failed" << std::endl;
+    }
+    return ok;
+}
+
+#endif
+
+// Spawn the clang++ driver with an argument vector, so no shell parses the
+// paths. Its output is collected into `errors`: a compile server passes that
+// back to the client instead of printing it on its own stderr.
+bool link_with_driver(const std::vector<std::string>& object_files, const std::string& runtime_library,
+                      const std::string& output_file, const LinkOptions& options,
+                      std::ostream& log, std::ostream& errors) {
+    std::vector<std::string> args = {"clang++", "-o", output_file};
+    if (options.static_link) {
+        args.push_back("-static");
+    } else if (!options.pie) {
+        args.push_back("-no-pie");
+    }
+    args.insert(args.end(), object_files.begin(), object_files.end());
+    if (!runtime_library.empty()) {
+        args.push_back(runtime_library);
+    }
+
+    if (options.verbose) {
+        log << "Running:";
+        for (const auto& arg : args) {
+            log << " " << arg;
+        }
+        log << std::endl;
+    }
+
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+
+    // Neither end may leak into a linker another thread starts meanwhile,
+    // or this read would wait for that one too
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) {
+        errors << "Error: could not run clang++: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    fcntl(pipe_fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(pipe_fds[1], F_SETFD, FD_CLOEXEC);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDERR_FILENO);
+    pid_t pid = 0;
+    int spawn_error = posix_spawnp(&pid, "clang++", &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipe_fds[1]);
+    if (spawn_error != 0) {
+        close(pipe_fds[0]);
+        errors << "Error: could not run clang++: " << std::strerror(spawn_error) << std::endl;
+        return false;
+    }
+
+    std::string output;
+    char buffer[4096];
+    for (;;) {
+        ssize_t count = read(pipe_fds[0], buffer, sizeof(buffer));
+        if (count > 0) {
+            output.append(buffer, static_cast<size_t>(count));
+        } else if (count == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    close(pipe_fds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+
+    errors << output;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        int code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        errors << "Error: clang linking failed (exit code " << code << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool link_executable(const std::vector<std::string>& object_files, const std::string& runtime_library,
+                     const std::string& output_file, const LinkOptions& options,
+                     std::ostream& log, std::ostream& errors) {
+#ifdef RIS_WITH_LLD
+    const Toolchain& toolchain = host_toolchain();
+    if (toolchain.found) {
+        auto args = linker_arguments(toolchain, object_files, runtime_library, output_file, options);
+        if (options.verbose) {
+            log << "Linking in-process:";
+            for (const auto& arg : args) {
+                log << " " << arg;
+            }
+            log << std::endl;
+        }
+        return link_with_lld(args, errors);
+    }
+
+    if (options.verbose) {
+        log << "Host C runtime not found, falling back to the clang++ driver" << std::endl;
+    }
+#endif
+    return link_with_driver(object_files, runtime_library, output_file, options, log, errors);
+}
+
+} // namespace ris
@@ -1,250 +1,107 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <fstream>
-#include <cstdlib>
-#include <sys/wait.h>
 #include <filesystem>
-#include "lexer.h"
-#include "parser.h"
-#include "semantic_analyzer.h"
-#include "codegen.h"
-#include "diagnostics.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#include "driver.h"
+#include "server.h"
 
 int main(int argc, char* argv[]) {
-    std::string input_file;
-    std::string output_file;
-    bool compile_executable = false;
-    bool auto_run = false;
-    bool output_specified = false;
-    bool verbose = false;
+    std::vector<std::string> args(argv + 1, argv + argc);
 
-    // Parse command line arguments
-    for (int i = 1; i < argc; i++) {
-        if (std::string(argv[i]) == "-o" && i + 1 < argc) {
-            output_file = argv[i + 1];
-            output_specified = true;
-            // Check if output file doesn't have .ll extension (executable)
-            if (output_file.find(".ll") == std::string::npos) {
-                compile_executable = true;
-            }
-            i++; // Skip the next argument
-        } else if (std::string(argv[i]) == "--run") {
-            auto_run = true;
-        } else if (std::string(argv[i]) == "--verbose") {
-            verbose = true;
-        } else if (input_file.empty() && std::string(argv[i]) != "-o" && std::string(argv[i]) != "--run" && std::string(argv[i]) != "--verbose") {
-            // First non-flag argument is the input file
-            input_file = argv[i];
-        }
+    ris::Invocation invocation;
+    std::string error;
+    if (!ris::parse_arguments(args, "", invocation, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
     }
 
-    // Auto-derive output file name if not specified
-    if (!output_specified) {
-        if (auto_run) {
-            // For --run, derive executable name from input file
-            std::filesystem::path input_path(input_file);
-            output_file = input_path.stem().string(); // Remove extension
-            compile_executable = true;
-        } else {
-            // Default: derive executable name from input file
-            std::filesystem::path input_path(input_file);
-            output_file = input_path.stem().string(); // Remove extension
-            compile_executable = true;
-        }
+    std::string socket_path = invocation.socket_path.empty() ? ris::default_socket_path() : invocation.socket_path;
+    if (invocation.start_server) {
+        return ris::run_server(socket_path, invocation.options.verbose);
     }
 
-    if (input_file.empty()) {
-        std::cout << "Usage: " << argv[0] << " <input.ris> [-o <output>] [--run] [--verbose]" << std::endl;
+    if (invocation.jobs.empty()) {
+        std::cout << "Usage: " << argv[0] << " <input.ris>... [-o <output>] [--run] [--verbose] [-j <N>] [--batch <manifest>]" << std::endl;
+        std::cout << "       " << argv[0] << " build <main.ris> [-o <output>] [-j <N>]" << std::endl;
+        std::cout << "  build         : Compile each included .ris module separately, rebuilding only what changed" << std::endl;
         std::cout << "  -o <output>   : Specify output name (optional, auto-derived for --run)" << std::endl;
         std::cout << "  --run         : Auto-run executable after compilation" << std::endl;
         std::cout << "  --verbose     : Show detailed compilation information" << std::endl;
+        std::cout << "  -j <N>        : Compile N files at once, or split one file's code generation N ways" << std::endl;
+        std::cout << "  --batch <file>: Compile every '<input.ris> [output]' line of a manifest" << std::endl;
+        std::cout << "  --static      : Link a static executable (no dynamic loader at startup)" << std::endl;
+        std::cout << "  --no-pie      : Link a position-dependent executable" << std::endl;
+        std::cout << "  --target-cpu=<cpu>: Generate code for <cpu>; 'native' (or -march=native) uses this machine's CPU and features" << std::endl;
+        std::cout << "  --target-features=<list>: Enable/disable features on top of the CPU's, e.g. +avx2,-fma" << std::endl;
+        std::cout << "  --no-whole-program: Keep every function externally visible instead of optimizing across them" << std::endl;
+        std::cout << "  --tail-loops  : Rewrite self tail recursion (return f(...) inside f) into loops" << std::endl;
+        std::cout << "  --fast-math   : Let float arithmetic ignore NaN, infinities, signed zeros and rounding order" << std::endl;
+        std::cout << "  --fp-contract : Allow a*b+c to be fused into one multiply-add" << std::endl;
+        std::cout << "  --reassoc     : Allow float sums and products to be reordered (e.g. vectorized)" << std::endl;
+        std::cout << "  --no-signed-wrap: Treat int overflow as undefined so loops over ints optimize better" << std::endl;
+        std::cout << "  --no-cache    : Always recompile instead of reusing a cached executable" << std::endl;
+        std::cout << "  --server      : Run as a compile server on a Unix socket" << std::endl;
+        std::cout << "  --connect     : Send this compilation to a running compile server" << std::endl;
+        std::cout << "  --socket <path>: Socket for --server/--connect, in a directory only you can write to" << std::endl;
+        std::cout << "                  (default: $XDG_RUNTIME_DIR/risc.sock, else /tmp/risc-<uid>/server.sock)" << std::endl;
         return 1;
     }
 
-    // Check that input file has .ris extension
-    std::filesystem::path input_path(input_file);
-    if (input_path.extension() != ".ris") {
-        std::cerr << "Error: Input file must have .ris extension, got: " << input_file << std::endl;
-        return 1;
-    }
-
-    if (verbose) {
-        std::cout << "Input file: " << input_file << std::endl;
-        std::cout << "Output file: " << output_file << std::endl;
-    }
-
-    // Read input file
-    std::ifstream file(input_file);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open input file " << input_file << std::endl;
-        return 1;
-    }
-
-    std::string source((std::istreambuf_iterator<char>(file)),
-                      std::istreambuf_iterator<char>());
-    file.close();
-
-    // Get the directory of the source file
-    // std::filesystem::path input_path(input_file);
-    std::string source_dir = input_path.parent_path().string();
-    if (source_dir.empty()) {
-        source_dir = ".";
-    }
-
-    // Tokenize the source
-    ris::Lexer lexer(source, source_dir);
-    auto tokens = lexer.tokenize();
-
-    if (lexer.has_error()) {
-        std::cerr << "Lexer error: " << lexer.error_message() << std::endl;
-        return 1;
-    }
-
-    // Check if std library is included
-    bool needs_std_lib = lexer.includes_std();
-
-    if (verbose) {
-        std::cout << "Tokenized " << tokens.size() << " tokens" << std::endl;
-        if (needs_std_lib) {
-            std::cout << "Std library will be linked (found #include <std>)" << std::endl;
-        } else {
-            std::cout << "Std library will NOT be linked (no #include <std> found)" << std::endl;
+    ris::InvocationResult result;
+    bool served = false;
+    if (invocation.use_server) {
+        // The server resolves relative paths against our directory and writes the artifacts itself
+        served = ris::run_client(socket_path, args, std::filesystem::current_path().string(), result);
+        if (!served && invocation.options.verbose) {
+            std::cout << "No compile server at " << socket_path << ", compiling locally" << std::endl;
         }
     }
-
-    // Parse the tokens into AST
-    ris::Parser parser(tokens);
-    auto program = parser.parse();
-
-    if (parser.has_error()) {
-        std::cerr << "Parser error: " << parser.error_message() << std::endl;
-        return 1;
+    if (!served) {
+        result = ris::run_invocation(invocation);
     }
 
-    if (verbose) {
-        std::cout << "Parsed successfully!" << std::endl;
-        std::cout << "Functions: " << program->functions.size() << std::endl;
-        std::cout << "Global variables: " << program->globals.size() << std::endl;
-    }
-
-    // Perform semantic analysis
-    ris::SemanticAnalyzer analyzer;
-    bool semantic_ok = analyzer.analyze(*program);
+    std::cout << result.log;
+    std::cerr << result.errors;
 
-    if (!semantic_ok) {
-        std::cerr << "Semantic analysis failed:" << std::endl;
-        for (const auto& error : analyzer.errors()) {
-            std::cerr << "  " << error << std::endl;
-        }
-        return 1;
-    }
-
-    if (verbose) {
-        std::cout << "Semantic analysis passed!" << std::endl;
+    if (result.exit_code != 0 || invocation.jobs[0].emit_llvm) {
+        return result.exit_code;
     }
 
-    // Generate LLVM IR
-    std::string llvm_output = compile_executable ? "out/temp_output.ll" : "out/" + output_file;
-
-    // Ensure out directory exists for LLVM IR generation
-    std::filesystem::create_directories("out");
-
-    ris::CodeGenerator codegen;
-    bool codegen_ok = codegen.generate(std::move(program), llvm_output);
-
-    if (!codegen_ok) {
-        std::cerr << "Code generation failed: " << codegen.error_message() << std::endl;
-        return 1;
+    // Run what was asked for, not a path a server reported back
+    std::string final_output = ris::executable_path(invocation.jobs[0], "");
+    if (!std::filesystem::path(final_output).is_absolute()) {
+        final_output = "./" + final_output;
     }
-
-    if (compile_executable) {
-        if (verbose) {
-            std::cout << "Code generation completed! Compiling to executable..." << std::endl;
-        }
-
-        // Ensure out directory exists
-        std::filesystem::create_directories("out");
-
-        // Use LLVM toolchain: llc -> clang for linking
-        std::string asm_output = "out/temp_output.s";
-        std::string std_lib = "runtime/std.a";
-        std::string final_output = output_file;
-
-        #ifdef _WIN32
-            final_output += ".exe";
-        #endif
-
-        // Step 1: Use llc to generate assembly from LLVM IR
-        std::string llc_cmd = "llc -o " + asm_output + " " + llvm_output;
-
-        if (verbose) {
-            std::cout << "Running: " << llc_cmd << std::endl;
-        }
-
-        int llc_result = std::system(llc_cmd.c_str());
-        if (llc_result != 0) {
-            std::cerr << "Error: llc failed to generate assembly (exit code " << llc_result << ")" << std::endl;
-            std::remove(llvm_output.c_str());
-            return 1;
+    if (invocation.auto_run) {
+        if (invocation.options.verbose) {
+            std::cout << "Auto-running executable..." << std::endl;
+            std::cout << "--- Output ---" << std::endl;
         }
 
-        // Step 2: Use clang to link assembly with runtime library (if needed)
-        std::string link_cmd = "clang++ -o " + final_output + " " + asm_output;
-        if (needs_std_lib) {
-            link_cmd += " " + std_lib;
+        // Run the executable directly; no shell ever sees its path
+        std::cout.flush();
+        int exit_code = 127;
+        pid_t pid = fork();
+        if (pid == 0) {
+            execl(final_output.c_str(), final_output.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
         }
-
-        if (verbose) {
-            std::cout << "Running: " << link_cmd << std::endl;
+        int status = 0;
+        if (pid > 0 && waitpid(pid, &status, 0) == pid) {
+            exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
         }
 
-        int link_result = std::system(link_cmd.c_str());
-        if (link_result != 0) {
-            std::cerr << "Error: clang linking failed (exit code " << link_result << ")" << std::endl;
-            std::remove(llvm_output.c_str());
-            std::remove(asm_output.c_str());
-            return 1;
-        }
-
-        // Clean up temporary files
-        std::remove(llvm_output.c_str());
-        std::remove(asm_output.c_str());
-
-        if (verbose) {
-            std::cout << "Executable created: " << output_file << std::endl;
+        if (invocation.options.verbose) {
+            std::cout << "--- End Output ---" << std::endl;
+            std::cout << "Executable exited with code: " << exit_code << std::endl;
         }
 
-        if (auto_run) {
-            if (verbose) {
-                std::cout << "Auto-running executable..." << std::endl;
-                std::cout << "--- Output ---" << std::endl;
-            }
-
-            // Run the executable
-            std::string run_cmd = "./" + final_output;
-            int run_result = std::system(run_cmd.c_str());
-
-            // Extract the actual exit code from system() result
-            // On Unix systems, system() returns the exit code in the high byte
-            int exit_code = WEXITSTATUS(run_result);
-
-            if (verbose) {
-                std::cout << "--- End Output ---" << std::endl;
-                std::cout << "Executable exited with code: " << exit_code << std::endl;
-            }
-
-            // Exit with the same code as the executed program
-            return exit_code;
-        } else {
-            if (verbose) {
-                std::cout << "Run with: ./" << final_output << std::endl;
-            }
-        }
-    } else {
-        if (verbose) {
-            std::cout << "Code generation completed! Output written to " << output_file << std::endl;
-        }
+        // Exit with the same code as the executed program
+        return exit_code;
+    } else if (invocation.options.verbose && invocation.jobs.size() == 1) {
+        std::cout << "Run with: " << final_output << std::endl;
     }
 
     return 0;
@@ -0,0 +1,415 @@
+#include "module_build.h"
+#include "cache.h"
+#include "constant_folding.h"
+#include "escape_analysis.h"
+#include "lexer.h"
+#include "parser.h"
+#include "semantic_analyzer.h"
+#include "tail_recursion.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace ris {
+
+namespace {
+
+// One separately compiled .ris file
+struct ModuleUnit {
+    std::string path;              // Canonical source path
+    std::string name;              // File name stem inside the build directory
+    std::vector<size_t> deps;      // Units this one includes
+    size_t level = 0;              // 0 = includes nothing, otherwise 1 + deepest dependency
+    bool needs_std_lib = false;
+    bool rebuilt = false;
+    std::string interface_text;    // Prototypes of the functions this unit defines
+    std::string log;
+    std::string errors;
+    bool ok = false;
+};
+
+bool read_file(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    contents.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool write_file(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+    return static_cast<bool>(file);
+}
+
+std::string canonical_path(const std::string& path) {
+    std::error_code ec;
+    auto canonical = std::filesystem::weakly_canonical(path, ec);
+    return ec ? path : canonical.string();
+}
+
+// Render the exported signatures of a unit in the same syntax the parser accepts
+std::string make_interface(const Program& program) {
+    std::ostringstream out;
+    for (const auto& func : program.functions) {
+        if (!func->body || func->name == "main") {
+            continue;
+        }
+        // Callers in other units lay out calls to @cold functions accordingly
+        for (const auto& annotation : func->annotations) {
+            out << "@" << annotation.name << " ";
+        }
+        // Const functions in other units may call this one
+        if (func->is_const) {
+            out << "const ";
+        }
+        out << func->return_type << " " << func->name << "(";
+        for (size_t i = 0; i < func->parameters.size(); ++i) {
+            if (i > 0) {
+                out << ", ";
+            }
+            out << func->parameters[i].first << " " << func->parameters[i].second;
+        }
+        out << ");\n";
+    }
+    return out.str();
+}
+
+class ModuleGraph {
+public:
+    ModuleGraph(const DriverOptions& options, const std::string& build_dir)
+        : options_(options), build_dir_(build_dir) {}
+
+    // Collect the root and every unit it reaches through includes
+    bool discover(const std::string& root, std::string& error) {
+        std::vector<std::string> stack;
+        return visit(canonical_path(root), stack, error);
+    }
+
+    // Compile out-of-date units, dependencies first, one dependency level at a time
+    void compile() {
+        size_t max_level = 0;
+        for (const auto& unit : units_) {
+            max_level = std::max(max_level, unit.level);
+        }
+
+        for (size_t level = 0; level <= max_level; ++level) {
+            std::vector<size_t> ready;
+            for (size_t i = 0; i < units_.size(); ++i) {
+                if (units_[i].level == level && deps_ok(units_[i])) {
+                    ready.push_back(i);
+                }
+            }
+            parallel_for(ready.size(), options_.jobs, [&](size_t i) {
+                compile_unit(units_[ready[i]]);
+            });
+        }
+    }
+
+    std::vector<ModuleUnit>& units() { return units_; }
+
+    std::string object_file(const ModuleUnit& unit) const { return build_file(unit, ".o"); }
+
+private:
+    const DriverOptions& options_;
+    std::string build_dir_;
+    std::vector<ModuleUnit> units_; // Root first
+    std::map<std::string, size_t> index_;
+
+    std::string build_file(const ModuleUnit& unit, const std::string& extension) const {
+        return (std::filesystem::path(build_dir_) / (unit.name + extension)).string();
+    }
+
+    // Splice a unit's interface after those of everything it includes, as
+    // nested source includes would; each unit appears at most once
+    void splice_interface(size_t index, std::set<size_t>& spliced, std::string& content) const {
+        if (!spliced.insert(index).second) {
+            return;
+        }
+        for (size_t dep : units_[index].deps) {
+            splice_interface(dep, spliced, content);
+        }
+        content += units_[index].interface_text;
+    }
+
+    bool deps_ok(const ModuleUnit& unit) const {
+        for (size_t dep : unit.deps) {
+            if (!units_[dep].ok) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool visit(const std::string& path, std::vector<std::string>& stack, std::string& error) {
+        if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+            error = "Include cycle through " + path;
+            return false;
+        }
+        if (index_.count(path)) {
+            return true;
+        }
+
+        std::string source;
+        if (!read_file(path, source)) {
+            error = "Could not open input file " + path;
+            return false;
+        }
+
+        // Lex with an empty reader only to learn which files this unit includes
+        Lexer lexer(source, std::filesystem::path(path).parent_path().string());
+        lexer.set_include_reader([](const std::string&, std::string&) { return true; });
+        lexer.tokenize();
+        if (lexer.has_error()) {
+            error = "Lexer error in " + path + ": " + lexer.error_message();
+            return false;
+        }
+
+        size_t index = units_.size();
+        index_[path] = index;
+        units_.emplace_back();
+        units_[index].path = path;
+
+        CacheKey path_key;
+        path_key.add(path);
+        units_[index].name = std::filesystem::path(path).stem().string() + "-" + path_key.digest().substr(0, 8);
+
+        stack.push_back(path);
+        for (const auto& included : lexer.included_files()) {
+            std::string dep_path = canonical_path(included);
+            if (!visit(dep_path, stack, error)) {
+                return false;
+            }
+            size_t dep = index_[dep_path];
+            units_[index].deps.push_back(dep);
+            units_[index].level = std::max(units_[index].level, units_[dep].level + 1);
+        }
+        stack.pop_back();
+        return true;
+    }
+
+    void compile_unit(ModuleUnit& unit) {
+        std::ostringstream log;
+        std::ostringstream errors;
+        unit.ok = build_unit(unit, log, errors);
+        unit.log = log.str();
+        unit.errors = errors.str();
+    }
+
+    bool build_unit(ModuleUnit& unit, std::ostream& log, std::ostream& errors) {
+        std::string source;
+        if (!read_file(unit.path, source)) {
+            errors << "Error: Could not open input file " << unit.path << std::endl;
+            return false;
+        }
+
+        // Included units contribute their interfaces, never their source
+        Lexer lexer(source, std::filesystem::path(unit.path).parent_path().string());
+        std::set<size_t> spliced;
+        lexer.set_include_reader([this, &spliced](const std::string& path, std::string& content) {
+            auto it = index_.find(canonical_path(path));
+            if (it == index_.end()) {
+                return false;
+            }
+            content.clear();
+            splice_interface(it->second, spliced, content);
+            return true;
+        });
+        auto tokens = lexer.tokenize();
+        if (lexer.has_error()) {
+            errors << "Lexer error: " << lexer.error_message() << std::endl;
+            return false;
+        }
+        unit.needs_std_lib = lexer.includes_std();
+
+        bool is_root = &unit == &units_.front();
+        CacheKey key;
+        key.add(CompileCache::compiler_version());
+        key.add("opt " + std::to_string(options_.codegen.opt_level));
+        key.add(options_.codegen.pic ? "pic" : "static");
+        std::string cpu, features;
+        CodeGenerator::resolve_target(options_.codegen, cpu, features);
+        key.add("cpu " + cpu + " " + features);
+        key.add(options_.tail_loops ? "tail-loops" : "tail-calls");
+        key.add(CodeGenerator::arithmetic_mode(options_.codegen));
+        key.add(is_root ? "root" : "module");
+        if (is_root) {
+            // Module units never build as a whole program; the root does unless --no-whole-program
+            key.add(options_.codegen.whole_program ? "whole-program" : "per-function");
+        }
+        key.add_tokens(tokens);
+        std::string stamp = key.digest();
+
+        std::string object_path = object_file(unit);
+        std::string interface_path = build_file(unit, ".risi");
+        std::string stamp_path = build_file(unit, ".stamp");
+
+        std::string old_stamp;
+        if (read_file(stamp_path, old_stamp) && old_stamp == stamp &&
+            std::filesystem::exists(object_path) && read_file(interface_path, unit.interface_text)) {
+            if (options_.verbose) {
+                log << "Module " << unit.path << " is up to date" << std::endl;
+            }
+            return true;
+        }
+
+        if (options_.verbose) {
+            log << "Compiling module " << unit.path << std::endl;
+        }
+
+        Parser parser(tokens);
+        auto program = parser.parse();
+        if (parser.has_error()) {
+            errors << "Parser error in " << unit.path << ": " << parser.error_message() << std::endl;
+            return false;
+        }
+
+        SemanticAnalyzer analyzer;
+        analyzer.set_jobs(1);
+        if (!analyzer.analyze(*program)) {
+            errors << "Semantic analysis failed in " << unit.path << ":" << std::endl;
+            for (const auto& error : analyzer.errors()) {
+                errors << "  " << error << std::endl;
+            }
+            return false;
+        }
+
+        unit.interface_text = make_interface(*program);
+        fold_constants(*program);
+        if (options_.tail_loops) {
+            rewrite_tail_recursion(*program);
+        }
+        mark_stack_lists(*program);
+
+        CodeGenOptions codegen_options = options_.codegen;
+        codegen_options.jobs = 1;
+        codegen_options.module_unit = !is_root;
+        CodeGenerator codegen(codegen_options);
+
+        std::vector<std::string> object_files;
+        std::string prefix = build_file(unit, "");
+        if (!codegen.generate_objects(std::move(program), prefix, object_files) || object_files.size() != 1) {
+            errors << "Code generation failed in " << unit.path << ": " << codegen.error_message() << std::endl;
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(object_files[0], object_path, ec);
+
+        // The stamp goes last so an interrupted build is redone next time
+        if (ec || !write_file(interface_path, unit.interface_text) || !write_file(stamp_path, stamp)) {
+            errors << "Error: Could not write build products for " << unit.path << std::endl;
+            return false;
+        }
+
+        unit.rebuilt = true;
+        return true;
+    }
+};
+
+} // namespace
+
+CompileResult build_program(const CompileJob& job, const DriverOptions& options) {
+    CompileResult result;
+    std::ostringstream log;
+    std::ostringstream errors;
+
+    auto finish = [&](bool ok) {
+        result.ok = ok;
+        result.log = log.str();
+        result.errors = errors.str();
+        return result;
+    };
+
+    std::string input_file = resolve_path(job.input_file, options.working_dir);
+    if (std::filesystem::path(input_file).extension() != ".ris") {
+        errors << "Error: Input file must have .ris extension, got: " << job.input_file << std::endl;
+        return finish(false);
+    }
+
+    std::string output_file = job.output_file.empty() ? std::filesystem::path(job.input_file).stem().string() : job.output_file;
+    std::string final_output = executable_path(job, options.working_dir);
+    std::string build_dir = resolve_path("out/modules", options.working_dir);
+
+    std::error_code ec;
+    std::filesystem::create_directories(build_dir, ec);
+    if (ec) {
+        errors << "Error: Could not create build directory " << build_dir << std::endl;
+        return finish(false);
+    }
+
+    ModuleGraph graph(options, build_dir);
+    std::string error;
+    if (!graph.discover(input_file, error)) {
+        errors << "Error: " << error << std::endl;
+        return finish(false);
+    }
+
+    graph.compile();
+
+    bool ok = true;
+    bool needs_relink = !std::filesystem::exists(final_output);
+    bool needs_std_lib = false;
+    std::vector<std::string> object_files;
+    for (const auto& unit : graph.units()) {
+        log << unit.log;
+        errors << unit.errors;
+        if (!unit.ok) {
+            if (unit.errors.empty()) {
+                errors << "Error: " << unit.path << " was not built because a module it includes failed" << std::endl;
+            }
+            ok = false;
+        }
+        needs_relink = needs_relink || unit.rebuilt;
+        needs_std_lib = needs_std_lib || unit.needs_std_lib;
+        object_files.push_back(graph.object_file(unit));
+    }
+    if (!ok) {
+        return finish(false);
+    }
+
+    // Objects that did not change still relink when --static or --no-pie did
+    std::string link_stamp_path = final_output + ".link";
+    std::string link_stamp = options.static_link ? "static" : options.pie ? "pie" : "no-pie";
+    std::string old_link_stamp;
+    needs_relink = needs_relink || !read_file(link_stamp_path, old_link_stamp) || old_link_stamp != link_stamp;
+
+    if (needs_relink) {
+        std::string std_lib = needs_std_lib ? resolve_path("runtime/std.a", options.working_dir) : "";
+        if (!link_executable(object_files, std_lib, final_output, link_options(options), log, errors)) {
+            return finish(false);
+        }
+        if (!write_file(link_stamp_path, link_stamp)) {
+            errors << "Error: Could not write " << link_stamp_path << std::endl;
+            return finish(false);
+        }
+        if (options.verbose) {
+            log << "Executable created: " << output_file << std::endl;
+        }
+    } else if (options.verbose) {
+        log << "Executable " << output_file << " is up to date" << std::endl;
+    }
+
+    // Make-style depfile: the executable depends on every unit's source
+    std::string depfile = final_output + ".d";
+    std::ostringstream deps;
+    deps << output_file << ":";
+    for (const auto& unit : graph.units()) {
+        deps << " " << unit.path;
+    }
+    deps << "\n";
+    if (!write_file(depfile, deps.str())) {
+        errors << "Error: Could not write depfile " << depfile << std::endl;
+        return finish(false);
+    }
+
+    result.output_file = final_output;
+    return finish(true);
+}
+
+} // namespace ris
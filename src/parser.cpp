@@ -25,7 +25,8 @@ std::unique_ptr<Program> Parser::parse() {
             while (lookahead < tokens_.size() && 
                    tokens_[lookahead].type != TokenType::LEFT_PAREN && 
                    tokens_[lookahead].type != TokenType::LEFT_BRACE &&
-                   tokens_[lookahead].type != TokenType::SEMICOLON) {
+                   tokens_[lookahead].type != TokenType::SEMICOLON &&
+                   tokens_[lookahead].type != TokenType::ASSIGN) {
                 lookahead++;
             }
             
@@ -48,6 +49,24 @@ std::unique_ptr<Program> Parser::parse() {
                     advance();
                 }
             }
+        } else if (check(TokenType::AT) || check(TokenType::CONST)) {
+            // Annotations and `const` only apply to functions at the top level
+            auto annotations = parse_annotations();
+            if (has_error_) {
+                break;
+            }
+            bool is_const = match(TokenType::CONST);
+            if (!is_type_keyword(current_token().type)) {
+                error(is_const ? "Expected function declaration after 'const'" : "Expected function declaration after annotation");
+                break;
+            }
+            auto func = parse_function();
+            if (!func) {
+                break;
+            }
+            func->annotations = std::move(annotations);
+            func->is_const = is_const;
+            program->functions.push_back(std::move(func));
         } else {
             error("Expected declaration");
             break;
@@ -157,6 +176,11 @@ std::unique_ptr<FuncDecl> Parser::parse_function() {
     
     consume(TokenType::RIGHT_PAREN, "Expected ')' after parameters");
     
+    // A prototype (`int f(int a);`) declares a function defined in another module
+    if (match(TokenType::SEMICOLON)) {
+        return func;
+    }
+    
     // Parse function body
     func->body = parse_block();
     
@@ -202,6 +226,8 @@ std::unique_ptr<Stmt> Parser::parse_statement() {
     switch (current_token().type) {
         case TokenType::LEFT_BRACE:
             return parse_block();
+        case TokenType::AT:
+            return parse_annotated_statement();
         case TokenType::IF:
             return parse_if_statement();
         case TokenType::WHILE:
@@ -263,7 +289,63 @@ std::unique_ptr<IfStmt> Parser::parse_if_statement() {
     return if_stmt;
 }
 
-std::unique_ptr<WhileStmt> Parser::parse_while_statement() {
+std::unique_ptr<Stmt> Parser::parse_annotated_statement() {
+    auto annotations = parse_annotations();
+    if (has_error_) {
+        return nullptr;
+    }
+    
+    if (check(TokenType::WHILE)) {
+        return parse_while_statement(std::move(annotations));
+    }
+    if (check(TokenType::FOR)) {
+        return parse_for_statement(std::move(annotations));
+    }
+    error("Expected 'for' or 'while' after loop annotation");
+    return nullptr;
+}
+
+// @name, @name(value, ...) or @name(key=value, ...); values are integers or identifiers
+std::vector<Annotation> Parser::parse_annotations() {
+    std::vector<Annotation> annotations;
+    
+    while (check(TokenType::AT)) {
+        Annotation annotation;
+        annotation.position = current_token().position;
+        advance(); // consume '@'
+        
+        if (!check(TokenType::IDENTIFIER)) {
+            error("Expected annotation name after '@'");
+            return annotations;
+        }
+        annotation.name = current_token().value;
+        advance();
+        
+        if (match(TokenType::LEFT_PAREN)) {
+            do {
+                std::string key;
+                if (check(TokenType::IDENTIFIER) && peek_token().type == TokenType::ASSIGN) {
+                    key = current_token().value;
+                    advance();
+                    advance(); // consume '='
+                }
+                if (!check(TokenType::INTEGER_LITERAL) && !check(TokenType::IDENTIFIER)) {
+                    error("Expected annotation argument");
+                    return annotations;
+                }
+                annotation.arguments.push_back({key, current_token().value});
+                advance();
+            } while (match(TokenType::COMMA));
+            consume(TokenType::RIGHT_PAREN, "Expected ')' after annotation arguments");
+        }
+        
+        annotations.push_back(std::move(annotation));
+    }
+    
+    return annotations;
+}
+
+std::unique_ptr<WhileStmt> Parser::parse_while_statement(std::vector<Annotation> annotations) {
     consume(TokenType::WHILE, "Expected 'while'");
     consume(TokenType::LEFT_PAREN, "Expected '(' after 'while'");
     
@@ -276,16 +358,18 @@ std::unique_ptr<WhileStmt> Parser::parse_while_statement() {
     consume(TokenType::RIGHT_PAREN, "Expected ')' after condition");
     
     auto while_stmt = std::make_unique<WhileStmt>(std::move(condition), current_token().position);
+    while_stmt->annotations = std::move(annotations);
     while_stmt->body = parse_statement();
     
     return while_stmt;
 }
 
-std::unique_ptr<ForStmt> Parser::parse_for_statement() {
+std::unique_ptr<ForStmt> Parser::parse_for_statement(std::vector<Annotation> annotations) {
     consume(TokenType::FOR, "Expected 'for'");
     consume(TokenType::LEFT_PAREN, "Expected '(' after 'for'");
     
     auto for_stmt = std::make_unique<ForStmt>(current_token().position);
+    for_stmt->annotations = std::move(annotations);
     
     // Parse initialization
     if (is_type_keyword(current_token().type)) {
@@ -349,14 +433,16 @@ std::unique_ptr<Expr> Parser::parse_expression() {
 std::unique_ptr<Expr> Parser::parse_assignment() {
     auto expr = parse_logical_or();
     
-    if (match(TokenType::ASSIGN)) {
+    if (is_assignment_operator(current_token().type)) {
+        Token op = current_token();
+        advance();
         auto right = parse_assignment();
         if (!right) {
-            error("Expected expression after '='");
+            error("Expected expression after '" + op.value + "'");
             return nullptr;
         }
         return std::make_unique<BinaryExpr>(std::move(expr), std::move(right), 
-                                           TokenType::ASSIGN, current_token().position);
+                                           op.type, current_token().position);
     }
     
     return expr;
@@ -507,7 +593,9 @@ std::unique_ptr<Expr> Parser::parse_primary() {
             advance(); // consume '.'
             if (check(TokenType::IDENTIFIER)) {
                 std::string method_name = current_token().value;
-                if (method_name == "push" || method_name == "pop" || method_name == "size" || method_name == "get") {
+                if (method_name == "push" || method_name == "pop" || method_name == "size" || method_name == "get" ||
+                    method_name == "reserve" || method_name == "resize" || method_name == "fill" ||
+                    method_name == "clear" || method_name == "extend" || method_name == "copy") {
                     // This is a list method call
                     auto list_expr = std::make_unique<IdentifierExpr>(name, current_token().position);
                     advance(); // consume method name
@@ -522,21 +610,21 @@ std::unique_ptr<Expr> Parser::parse_primary() {
                             }
                         }
                         consume(TokenType::RIGHT_PAREN, "Expected ')' after push argument");
-                    } else if (method_name == "get") {
-                        consume(TokenType::LEFT_PAREN, "Expected '(' after get");
+                    } else if (method_name != "pop" && method_name != "size") {
+                        consume(TokenType::LEFT_PAREN, "Expected '(' after " + method_name);
                         if (!check(TokenType::RIGHT_PAREN)) {
                             do {
                                 auto arg = parse_expression();
                                 if (arg) {
                                     arguments.push_back(std::move(arg));
                                 } else {
-                                    error("Expected index argument");
+                                    error("Expected " + method_name + " argument");
                                     break;
                                 }
                             } while (match(TokenType::COMMA));
                         }
-                        consume(TokenType::RIGHT_PAREN, "Expected ')' after get arguments");
-                    } else if (method_name == "pop" || method_name == "size") {
+                        consume(TokenType::RIGHT_PAREN, "Expected ')' after " + method_name + " arguments");
+                    } else {
                         consume(TokenType::LEFT_PAREN, "Expected '(' after " + method_name);
                         consume(TokenType::RIGHT_PAREN, "Expected ')' after " + method_name);
                     }
@@ -572,6 +660,10 @@ std::unique_ptr<Expr> Parser::parse_primary() {
                 result = std::make_unique<ListIndexExpr>(std::move(result), std::move(chained_index), current_token().position);
             }
             
+            if (match(TokenType::INCREMENT)) {
+                return std::make_unique<PostIncrementExpr>(std::move(result), current_token().position);
+            }
+            
             // Check for method calls on list index: a[i].size()
             if (check(TokenType::DOT)) {
                 consume(TokenType::DOT, "Expected '.' for method call");
@@ -1,16 +1,26 @@
 #include "semantic_analyzer.h"
 #include "types.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <map>
 #include <sstream>
 #include <iostream>
 
 namespace ris {
 
 SemanticAnalyzer::SemanticAnalyzer() 
-    : has_error_(false), error_message_("") {
+    : has_error_(false), error_message_(""), jobs_(0), global_scope_(symbol_table_.global_scope()),
+      body_purity_(FunctionPurity::Pure), body_may_not_return_(false) {
     // Add runtime functions to the global scope
     add_runtime_functions();
 }
 
+SemanticAnalyzer::SemanticAnalyzer(Scope* global_scope)
+    : symbol_table_(global_scope), has_error_(false), error_message_(""), jobs_(1), global_scope_(global_scope),
+      body_purity_(FunctionPurity::Pure), body_may_not_return_(false) {
+    // Runtime functions are already in the shared global scope
+}
+
 bool SemanticAnalyzer::analyze(Program& program) {
     has_error_ = false;
     error_message_ = "";
@@ -92,6 +102,7 @@ std::unique_ptr<Type> SemanticAnalyzer::analyze_expression_type(Expr& expr) {
                     }
                 }
                 // Fall through to arithmetic case
+                [[fallthrough]];
             case TokenType::MINUS:
             case TokenType::MULTIPLY:
             case TokenType::DIVIDE:
@@ -114,6 +125,11 @@ std::unique_ptr<Type> SemanticAnalyzer::analyze_expression_type(Expr& expr) {
                 return create_type("bool");
                 
             case TokenType::ASSIGN:
+            case TokenType::PLUS_ASSIGN:
+            case TokenType::MINUS_ASSIGN:
+            case TokenType::MULTIPLY_ASSIGN:
+            case TokenType::DIVIDE_ASSIGN:
+            case TokenType::MODULO_ASSIGN:
                 // Assignment returns the type of the left operand
                 return analyze_expression_type(*binary->left);
                 
@@ -181,8 +197,11 @@ std::unique_ptr<Type> SemanticAnalyzer::analyze_expression_type(Expr& expr) {
         } else if (list_method->method_name == "size") {
             // size() returns int
             return create_type("int");
-        } else if (list_method->method_name == "push" || list_method->method_name == "pop") {
-            // push() and pop() return void
+        } else if (list_method->method_name == "copy") {
+            // copy() returns a list of the same type
+            return analyze_expression_type(*list_method->list);
+        } else if (list_method->method_name != "get") {
+            // push(), pop() and the bulk operations return void
             return create_type("void");
         }
         return create_type("int"); // Default fallback
@@ -242,25 +261,178 @@ bool SemanticAnalyzer::check_boolean(const Type& type, const SourcePos& position
 }
 
 void SemanticAnalyzer::analyze_program(Program& program) {
-    // Analyze global variables first
+    // Phase one: collect every function signature, then the globals, into the
+    // global scope. After this the global scope is never written again.
+    std::vector<bool> declared(program.functions.size(), false);
+    for (size_t i = 0; i < program.functions.size(); ++i) {
+        declared[i] = declare_function(*program.functions[i]);
+    }
+    
     for (auto& var : program.globals) {
         analyze_variable_declaration(*var, true);
     }
     
-    // Then analyze functions
+    // Phase two: function bodies only read the global scope, so each one is
+    // checked by its own worker analyzer on the thread pool
+    Scope* global_scope = symbol_table_.global_scope();
+    std::vector<std::unique_ptr<SemanticAnalyzer>> workers(program.functions.size());
+    
+    parallel_for(program.functions.size(), jobs_, [&](size_t i) {
+        if (!declared[i] || !program.functions[i]->body) {
+            return;
+        }
+        workers[i].reset(new SemanticAnalyzer(global_scope));
+        workers[i]->analyze_function_body(*program.functions[i]);
+    });
+    
+    // Merge diagnostics in declaration order so the output is deterministic
+    for (const auto& worker : workers) {
+        if (worker) {
+            merge_results(*worker);
+        }
+    }
+    
+    if (!has_error_) {
+        check_const_functions(program, workers);
+    }
+    if (!has_error_) {
+        infer_function_effects(program, workers);
+    }
+}
+
+void SemanticAnalyzer::check_const_functions(const Program& program,
+                                             const std::vector<std::unique_ptr<SemanticAnalyzer>>& workers) {
+    // A const function may only compute from its arguments, so that the
+    // compiler can run it in place of a call whose arguments are constants.
+    // A definition decides; a prototype only speaks for a function defined
+    // in another unit, whose own build checked it.
+    std::set<std::string> defined;
+    for (const auto& func : program.functions) {
+        if (func->body) {
+            defined.insert(func->name);
+        }
+    }
+    std::set<std::string> const_functions;
+    for (const auto& func : program.functions) {
+        if (func->is_const && (func->body || !defined.count(func->name))) {
+            const_functions.insert(func->name);
+        }
+    }
+    
+    for (size_t i = 0; i < program.functions.size(); ++i) {
+        const FuncDecl& func = *program.functions[i];
+        if (!func.is_const || !workers[i]) {
+            continue;
+        }
+        std::string reason = workers[i]->body_runtime_only_;
+        for (const auto& callee : workers[i]->body_callees_) {
+            if (reason.empty() && !const_functions.count(callee)) {
+                reason = "calls non-const function '" + callee + "'";
+            }
+        }
+        if (!reason.empty()) {
+            error("Const function '" + func.name + "' cannot run at compile time: it " + reason, func.position);
+        }
+    }
+}
+
+void SemanticAnalyzer::infer_function_effects(Program& program,
+                                              const std::vector<std::unique_ptr<SemanticAnalyzer>>& workers) {
+    // Each worker recorded what its body does directly; callees are folded in
+    // here. Purity starts optimistic and only ever drops, so recursion within
+    // otherwise pure code stays pure. Termination starts pessimistic and only
+    // ever rises, so recursion never counts as terminating.
+    std::map<std::string, FuncDecl*> definitions;
+    for (auto& func : program.functions) {
+        if (func->body) {
+            definitions[func->name] = func.get();
+        }
+    }
+    
+    for (size_t i = 0; i < program.functions.size(); ++i) {
+        if (workers[i]) {
+            program.functions[i]->purity = workers[i]->body_purity_;
+            program.functions[i]->always_returns = false;
+        }
+    }
+    
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < program.functions.size(); ++i) {
+            if (!workers[i]) {
+                continue;
+            }
+            FuncDecl& func = *program.functions[i];
+            FunctionPurity purity = workers[i]->body_purity_;
+            bool returns = !workers[i]->body_may_not_return_;
+            for (const auto& callee_name : workers[i]->body_callees_) {
+                auto callee = definitions.find(callee_name);
+                if (callee == definitions.end()) {
+                    // Defined in another module: nothing is known about it
+                    purity = FunctionPurity::SideEffects;
+                    returns = false;
+                    continue;
+                }
+                purity = std::min(purity, callee->second->purity);
+                returns = returns && callee->second->always_returns;
+            }
+            if (purity != func.purity || returns != func.always_returns) {
+                func.purity = purity;
+                func.always_returns = returns;
+                changed = true;
+            }
+        }
+    }
+    
+    // Prototypes describe the same function as its definition
     for (auto& func : program.functions) {
-        analyze_function(*func);
+        auto definition = definitions.find(func->name);
+        if (!func->body && definition != definitions.end()) {
+            func->purity = definition->second->purity;
+            func->always_returns = definition->second->always_returns;
+        }
+    }
+}
+
+void SemanticAnalyzer::note_effect(FunctionPurity purity) {
+    body_purity_ = std::min(body_purity_, purity);
+}
+
+void SemanticAnalyzer::note_runtime_only(const std::string& reason) {
+    if (body_runtime_only_.empty()) {
+        body_runtime_only_ = reason;
+    }
+}
+
+void SemanticAnalyzer::note_allocation() {
+    // The runtime stops the program when memory runs out
+    note_effect(FunctionPurity::SideEffects);
+    body_may_not_return_ = true;
+}
+
+void SemanticAnalyzer::note_variable_access(const std::string& name, bool write) {
+    // Locals and parameters live in the function's own frame
+    Symbol* symbol = symbol_table_.lookup(name);
+    if (symbol && global_scope_ && global_scope_->lookup_local(name) == symbol) {
+        note_effect(write ? FunctionPurity::SideEffects : FunctionPurity::ReadOnly);
+        note_runtime_only("uses global '" + name + "'");
     }
 }
 
-void SemanticAnalyzer::analyze_function(FuncDecl& func) {
+bool SemanticAnalyzer::declare_function(FuncDecl& func) {
+    if (func.name == "likely" || func.name == "unlikely") {
+        error("'" + func.name + "' is a built-in branch hint and cannot be redefined", func.position);
+        return false;
+    }
+    
     // Create function type
     std::vector<std::unique_ptr<Type>> param_types;
     for (const auto& param : func.parameters) {
         auto param_type = analyze_type(param.first);
         if (!param_type) {
             error("Unknown parameter type: " + param.first, func.position);
-            return;
+            return false;
         }
         param_types.push_back(std::move(param_type));
     }
@@ -268,7 +440,7 @@ void SemanticAnalyzer::analyze_function(FuncDecl& func) {
     auto return_type = analyze_type(func.return_type);
     if (!return_type) {
         error("Unknown return type: " + func.return_type, func.position);
-        return;
+        return false;
     }
     
     // Add function to symbol table
@@ -279,14 +451,35 @@ void SemanticAnalyzer::analyze_function(FuncDecl& func) {
         func.position
     );
     
+    std::string signature = func_symbol->to_string();
     if (!symbol_table_.add_symbol(std::move(func_symbol))) {
-        error("Function '" + func.name + "' already declared", func.position);
-        return;
+        // Prototypes may repeat an earlier declaration as long as the signatures
+        // agree, but a function can only have one body
+        auto* existing = dynamic_cast<FunctionSymbol*>(symbol_table_.lookup(func.name));
+        bool redefinition = func.body && defined_functions_.count(func.name);
+        if (!existing || existing->to_string() != signature || redefinition) {
+            error("Function '" + func.name + "' already declared", func.position);
+            return false;
+        }
     }
     
+    check_function_annotations(func);
+    
+    if (func.body) {
+        defined_functions_.insert(func.name);
+    }
+    
+    return true;
+}
+
+void SemanticAnalyzer::analyze_function_body(FuncDecl& func) {
     // Track current function for return statement analysis
     current_function_name_ = func.name;
     current_function_return_type_ = func.return_type;
+    body_purity_ = FunctionPurity::Pure;
+    body_may_not_return_ = false;
+    body_callees_.clear();
+    body_runtime_only_.clear();
     
     // Enter function scope
     symbol_table_.enter_scope();
@@ -323,6 +516,20 @@ void SemanticAnalyzer::analyze_function(FuncDecl& func) {
     current_function_return_type_.clear();
 }
 
+void SemanticAnalyzer::merge_results(const SemanticAnalyzer& worker) {
+    if (worker.has_error_) {
+        has_error_ = true;
+        if (error_message_.empty()) {
+            error_message_ = worker.error_message_;
+        }
+        errors_.insert(errors_.end(), worker.errors_.begin(), worker.errors_.end());
+    }
+    
+    for (const auto& diag : worker.diagnostics_.get_diagnostics()) {
+        diagnostics_.add_diagnostic(diag.severity, diag.message, diag.position, diag.component);
+    }
+}
+
 void SemanticAnalyzer::analyze_variable_declaration(VarDecl& var, bool /* is_global */) {
     std::unique_ptr<Type> var_type;
     
@@ -419,7 +626,81 @@ void SemanticAnalyzer::analyze_if_statement(IfStmt& stmt) {
     }
 }
 
+void SemanticAnalyzer::check_loop_annotations(const std::vector<Annotation>& annotations) {
+    auto is_count = [](const std::string& value) {
+        return !value.empty() && value.size() < 10 && value.find_first_not_of("0123456789") == std::string::npos &&
+               std::stoul(value) > 0;
+    };
+    
+    bool unroll = false;
+    bool no_unroll = false;
+    bool vectorize = false;
+    bool no_vectorize = false;
+    for (const auto& annotation : annotations) {
+        const auto& args = annotation.arguments;
+        const std::string& name = annotation.name;
+        bool ok = true;
+        if (name == "unroll") {
+            unroll = true;
+            ok = args.empty() || (args.size() == 1 && args[0].first.empty() &&
+                                  (args[0].second == "full" || is_count(args[0].second)));
+        } else if (name == "vectorize") {
+            vectorize = true;
+            ok = args.empty() || (args.size() == 1 && (args[0].first.empty() || args[0].first == "width") &&
+                                  is_count(args[0].second));
+        } else if (name == "interleave") {
+            ok = args.size() == 1 && (args[0].first.empty() || args[0].first == "count") && is_count(args[0].second);
+        } else if (name == "no_unroll" || name == "no_vectorize") {
+            no_unroll = no_unroll || name == "no_unroll";
+            no_vectorize = no_vectorize || name == "no_vectorize";
+            ok = args.empty();
+        } else {
+            error("Unknown loop annotation '@" + name + "'. Expected @unroll, @no_unroll, @vectorize, @no_vectorize or @interleave.", annotation.position);
+            continue;
+        }
+        
+        if (!ok) {
+            error("Invalid arguments to '@" + name + "'. Use @unroll, @unroll(N), @unroll(full), @vectorize, @vectorize(width=N) or @interleave(N) with N > 0.", annotation.position);
+        }
+    }
+    
+    if (unroll && no_unroll) {
+        error("A loop cannot be both @unroll and @no_unroll.", annotations.front().position);
+    }
+    if (vectorize && no_vectorize) {
+        error("A loop cannot be both @vectorize and @no_vectorize.", annotations.front().position);
+    }
+}
+
+void SemanticAnalyzer::check_function_annotations(const FuncDecl& func) {
+    // A prototype and the definition end up on one LLVM function, so their
+    // annotations are checked together
+    std::set<std::string>& seen = function_annotations_[func.name];
+    bool inline_conflict = seen.count("inline") && seen.count("noinline");
+    bool hot_conflict = seen.count("hot") && seen.count("cold");
+    for (const auto& annotation : func.annotations) {
+        const std::string& name = annotation.name;
+        if (name != "inline" && name != "noinline" && name != "hot" && name != "cold" && name != "flatten") {
+            error("Unknown function annotation '@" + name + "'. Expected @inline, @noinline, @hot, @cold or @flatten.", annotation.position);
+        } else if (!annotation.arguments.empty()) {
+            error("Annotation '@" + name + "' takes no arguments.", annotation.position);
+        }
+        seen.insert(name);
+    }
+    
+    if (!inline_conflict && seen.count("inline") && seen.count("noinline")) {
+        error("Function '" + func.name + "' cannot be both @inline and @noinline.", func.position);
+    }
+    if (!hot_conflict && seen.count("hot") && seen.count("cold")) {
+        error("Function '" + func.name + "' cannot be both @hot and @cold.", func.position);
+    }
+}
+
 void SemanticAnalyzer::analyze_while_statement(WhileStmt& stmt) {
+    // Loops are not proven to terminate
+    body_may_not_return_ = true;
+    check_loop_annotations(stmt.annotations);
+    
     if (stmt.condition) {
         analyze_expression(*stmt.condition);
         auto cond_type = analyze_expression_type(*stmt.condition);
@@ -434,6 +715,9 @@ void SemanticAnalyzer::analyze_while_statement(WhileStmt& stmt) {
 }
 
 void SemanticAnalyzer::analyze_for_statement(ForStmt& stmt) {
+    body_may_not_return_ = true;
+    check_loop_annotations(stmt.annotations);
+    
     symbol_table_.enter_scope();
     
     if (stmt.init) {
@@ -545,10 +829,12 @@ void SemanticAnalyzer::analyze_binary_expression(BinaryExpr& expr) {
         case TokenType::PLUS:
             // Allow string concatenation: string + string
             if (left_type->to_string() == "string" && right_type->to_string() == "string") {
-                // String concatenation is allowed
+                // String concatenation is allowed; it allocates the result
+                note_allocation();
                 break;
             }
             // Fall through to arithmetic check for numeric types
+            [[fallthrough]];
         case TokenType::MINUS:
         case TokenType::MULTIPLY:
         case TokenType::DIVIDE:
@@ -564,6 +850,15 @@ void SemanticAnalyzer::analyze_binary_expression(BinaryExpr& expr) {
         case TokenType::LESS_EQUAL:
         case TokenType::GREATER_EQUAL:
             check_comparable(*left_type, *right_type, expr.position);
+            // Lists are equal when their elements are, not when they are the same list
+            if (expr.op == TokenType::EQUAL || expr.op == TokenType::NOT_EQUAL) {
+                if (auto* list = dynamic_cast<const ListType*>(left_type.get())) {
+                    if (dynamic_cast<const ListType*>(right_type.get())) {
+                        expr.list_element_type = list->element_type().to_string();
+                        note_effect(FunctionPurity::ReadOnly);
+                    }
+                }
+            }
             break;
             
         case TokenType::AND:
@@ -572,8 +867,25 @@ void SemanticAnalyzer::analyze_binary_expression(BinaryExpr& expr) {
             check_boolean(*right_type, expr.position);
             break;
             
+        case TokenType::PLUS_ASSIGN:
+            if (left_type->to_string() == "string" && right_type->to_string() == "string") {
+                note_allocation();
+                check_assignment_target(*expr.left);
+                break;
+            }
+            // Fall through to arithmetic check for numeric types
+            [[fallthrough]];
+        case TokenType::MINUS_ASSIGN:
+        case TokenType::MULTIPLY_ASSIGN:
+        case TokenType::DIVIDE_ASSIGN:
+        case TokenType::MODULO_ASSIGN:
+            check_arithmetic(*left_type, expr.position);
+            check_arithmetic(*right_type, expr.position);
+            // Fall through: the result is stored back into the left side
+            [[fallthrough]];
         case TokenType::ASSIGN:
             check_assignable(*left_type, *right_type, expr.position);
+            check_assignment_target(*expr.left);
             break;
             
         default:
@@ -581,6 +893,17 @@ void SemanticAnalyzer::analyze_binary_expression(BinaryExpr& expr) {
     }
 }
 
+void SemanticAnalyzer::check_assignment_target(Expr& target) {
+    if (auto* identifier = dynamic_cast<IdentifierExpr*>(&target)) {
+        note_variable_access(identifier->name, true);
+    } else if (dynamic_cast<ListIndexExpr*>(&target)) {
+        // The list may be shared with the caller or other lists
+        note_effect(FunctionPurity::SideEffects);
+    } else {
+        error("Left side of assignment must be a variable or list element", target.position);
+    }
+}
+
 void SemanticAnalyzer::analyze_unary_expression(UnaryExpr& expr) {
     if (!expr.operand) {
         return;
@@ -610,6 +933,8 @@ void SemanticAnalyzer::analyze_unary_expression(UnaryExpr& expr) {
 void SemanticAnalyzer::analyze_call_expression(CallExpr& expr) {
     // Handle print functions specially
     if (expr.function_name == "print" || expr.function_name == "println") {
+        note_effect(FunctionPurity::SideEffects);
+        note_runtime_only("prints");
         // For print/println, allow any number of arguments of any type
         for (auto& arg : expr.arguments) {
             analyze_expression(*arg);
@@ -626,6 +951,25 @@ void SemanticAnalyzer::analyze_call_expression(CallExpr& expr) {
     
     auto* func_symbol = static_cast<FunctionSymbol*>(symbol);
     
+    // Runtime functions allocate, free or exit, except for the string length query
+    if (expr.function_name == "ris_string_length") {
+        note_effect(FunctionPurity::ReadOnly);
+    } else if (expr.function_name == "ris_malloc" || expr.function_name == "ris_string_concat") {
+        note_allocation();
+        note_runtime_only("calls " + expr.function_name);
+    } else if (expr.function_name == "ris_free") {
+        note_effect(FunctionPurity::SideEffects);
+        note_runtime_only("calls " + expr.function_name);
+    } else if (expr.function_name == "ris_exit") {
+        note_effect(FunctionPurity::SideEffects);
+        note_runtime_only("calls " + expr.function_name);
+        body_may_not_return_ = true;
+    } else if (expr.function_name == "likely" || expr.function_name == "unlikely") {
+        // Branch hints evaluate to their argument
+    } else {
+        body_callees_.insert(expr.function_name);
+    }
+    
     // Check argument count
     if (expr.arguments.size() != func_symbol->parameter_types().size()) {
         error("Function '" + expr.function_name + "' expects " + 
@@ -665,6 +1009,8 @@ void SemanticAnalyzer::analyze_identifier_expression(IdentifierExpr& expr) {
         error("'" + expr.name + "' is not a variable", expr.position);
         return;
     }
+    
+    note_variable_access(expr.name, false);
 }
 
 std::string SemanticAnalyzer::get_type_name_from_token(TokenType type) {
@@ -718,6 +1064,10 @@ void SemanticAnalyzer::add_runtime_functions() {
     add_func("ris_string_concat", "string", {"string", "string"});
     add_func("ris_string_length", "int", {"string"});
     add_func("ris_exit", "void", {"int"});
+    
+    // Branch hints: `if (unlikely(error)) { ... }`
+    add_func("likely", "bool", {"bool"});
+    add_func("unlikely", "bool", {"bool"});
 }
 
 void SemanticAnalyzer::analyze_switch_statement(SwitchStmt& stmt) {
@@ -775,6 +1125,9 @@ void SemanticAnalyzer::analyze_continue_statement(ContinueStmt& /* stmt */) {
 }
 
 void SemanticAnalyzer::analyze_list_literal_expression(ListLiteralExpr& expr) {
+    // Building a list allocates
+    note_allocation();
+    
     // Analyze all elements in the list
     for (auto& element : expr.elements) {
         if (element) {
@@ -796,6 +1149,8 @@ void SemanticAnalyzer::analyze_list_literal_expression(ListLiteralExpr& expr) {
 }
 
 void SemanticAnalyzer::analyze_list_index_expression(ListIndexExpr& expr) {
+    note_effect(FunctionPurity::ReadOnly);
+    
     if (expr.list) {
         analyze_expression(*expr.list);
     }
@@ -807,6 +1162,8 @@ void SemanticAnalyzer::analyze_list_index_expression(ListIndexExpr& expr) {
     auto list_type = analyze_expression_type(*expr.list);
     if (list_type && !dynamic_cast<const ListType*>(list_type.get())) {
         error("Indexing operator '[]' can only be used on lists", expr.position);
+    } else if (auto* list = dynamic_cast<const ListType*>(list_type.get())) {
+        expr.element_type = list->element_type().to_string();
     }
     
     // Check that the index is an integer
@@ -835,19 +1192,49 @@ void SemanticAnalyzer::analyze_list_method_call_expression(ListMethodCallExpr& e
         }
     }
     
+    // get and size only read the list; copy allocates, and the rest change it
+    note_effect(expr.method_name == "get" || expr.method_name == "size" ? FunctionPurity::ReadOnly
+                                                                         : FunctionPurity::SideEffects);
+    if (expr.method_name == "push" || expr.method_name == "reserve" || expr.method_name == "resize" ||
+        expr.method_name == "extend" || expr.method_name == "copy") {
+        note_allocation();
+    }
+    
+    auto list_type_ptr = dynamic_cast<const ListType*>(list_type.get());
+    if (list_type_ptr) {
+        expr.element_type = list_type_ptr->element_type().to_string();
+    }
+    
+    // Arguments that become list elements must have the element type
+    auto check_element = [&](Expr& arg) {
+        auto arg_type = analyze_expression_type(arg);
+        if (list_type_ptr && arg_type && !list_type_ptr->element_type().is_assignable_from(*arg_type)) {
+            error(expr.method_name + "() argument type must match list element type", expr.position);
+        }
+    };
+    auto check_count = [&](Expr& arg) {
+        auto arg_type = analyze_expression_type(arg);
+        if (arg_type && arg_type->to_string() != "int") {
+            error(expr.method_name + "() size argument must be an integer", expr.position);
+        }
+        
+        // The runtime stops on a negative size; a constant one is caught here
+        auto* negation = dynamic_cast<UnaryExpr*>(&arg);
+        auto* literal = negation && negation->op == TokenType::MINUS
+                            ? dynamic_cast<LiteralExpr*>(negation->operand.get())
+                            : nullptr;
+        if (literal && literal->type == TokenType::INTEGER_LITERAL &&
+            literal->value.find_first_not_of('0') != std::string::npos) {
+            error(expr.method_name + "() size argument must not be negative", expr.position);
+        }
+    };
+    
     // Validate method calls
     if (expr.method_name == "push") {
         if (expr.arguments.size() != 1) {
             error("push() method requires exactly one argument", expr.position);
         } else {
-            // Check that the argument type matches the list element type
-            auto list_type_ptr = dynamic_cast<const ListType*>(list_type.get());
-            if (list_type_ptr) {
-                auto arg_type = analyze_expression_type(*expr.arguments[0]);
-                if (arg_type && !list_type_ptr->element_type().is_assignable_from(*arg_type)) {
-                    error("push() argument type must match list element type", expr.position);
-                }
-            }
+            check_element(*expr.arguments[0]);
         }
     } else if (expr.method_name == "get") {
         if (expr.arguments.empty()) {
@@ -861,10 +1248,39 @@ void SemanticAnalyzer::analyze_list_method_call_expression(ListMethodCallExpr& e
                 }
             }
         }
-    } else if (expr.method_name == "pop" || expr.method_name == "size") {
+    } else if (expr.method_name == "pop" || expr.method_name == "size" || expr.method_name == "clear" ||
+               expr.method_name == "copy") {
         if (!expr.arguments.empty()) {
             error(expr.method_name + "() method takes no arguments", expr.position);
         }
+    } else if (expr.method_name == "reserve") {
+        if (expr.arguments.size() != 1) {
+            error("reserve() method requires exactly one argument", expr.position);
+        } else {
+            check_count(*expr.arguments[0]);
+        }
+    } else if (expr.method_name == "resize") {
+        if (expr.arguments.size() != 2) {
+            error("resize() method requires a size and a value", expr.position);
+        } else {
+            check_count(*expr.arguments[0]);
+            check_element(*expr.arguments[1]);
+        }
+    } else if (expr.method_name == "fill") {
+        if (expr.arguments.size() != 1) {
+            error("fill() method requires exactly one argument", expr.position);
+        } else {
+            check_element(*expr.arguments[0]);
+        }
+    } else if (expr.method_name == "extend") {
+        if (expr.arguments.size() != 1) {
+            error("extend() method requires exactly one argument", expr.position);
+        } else {
+            auto other_type = analyze_expression_type(*expr.arguments[0]);
+            if (list_type && other_type && !list_type->is_assignable_from(*other_type)) {
+                error("extend() argument must be a list of the same type", expr.position);
+            }
+        }
     } else {
         error("Unknown list method: " + expr.method_name, expr.position);
     }
@@ -878,11 +1294,12 @@ void SemanticAnalyzer::analyze_pre_increment_expression(PreIncrementExpr& expr)
     
     analyze_expression(*expr.operand);
     
-    // Check that the operand is a variable (not a literal or complex expression)
-    if (!dynamic_cast<IdentifierExpr*>(expr.operand.get())) {
-        error("Pre-increment operand must be a variable", expr.position);
+    // Check that the operand is a variable or list element (not a literal or complex expression)
+    if (!dynamic_cast<IdentifierExpr*>(expr.operand.get()) && !dynamic_cast<ListIndexExpr*>(expr.operand.get())) {
+        error("Pre-increment operand must be a variable or list element", expr.position);
         return;
     }
+    check_assignment_target(*expr.operand);
     
     // Check that the operand is an integer type
     auto operand_type = analyze_expression_type(*expr.operand);
@@ -902,11 +1319,12 @@ void SemanticAnalyzer::analyze_post_increment_expression(PostIncrementExpr& expr
     
     analyze_expression(*expr.operand);
     
-    // Check that the operand is a variable (not a literal or complex expression)
-    if (!dynamic_cast<IdentifierExpr*>(expr.operand.get())) {
-        error("Post-increment operand must be a variable", expr.position);
+    // Check that the operand is a variable or list element (not a literal or complex expression)
+    if (!dynamic_cast<IdentifierExpr*>(expr.operand.get()) && !dynamic_cast<ListIndexExpr*>(expr.operand.get())) {
+        error("Post-increment operand must be a variable or list element", expr.position);
         return;
     }
+    check_assignment_target(*expr.operand);
     
     // Check that the operand is an integer type
     auto operand_type = analyze_expression_type(*expr.operand);
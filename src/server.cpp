@@ -0,0 +1,271 @@
+#include "server.h"
+#include "codegen.h"
+#include "thread_pool.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ris {
+
+namespace {
+
+// Wire format: every message is a sequence of fields, each field a 32-bit
+// length in host byte order followed by that many bytes. Client and server
+// always run on the same machine, so no byte swapping is needed.
+
+bool write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool read_all(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t received = recv(fd, bytes, size, 0);
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+bool write_field(int fd, const std::string& field) {
+    uint32_t length = static_cast<uint32_t>(field.size());
+    return write_all(fd, &length, sizeof(length)) && write_all(fd, field.data(), field.size());
+}
+
+bool read_field(int fd, std::string& field) {
+    uint32_t length = 0;
+    if (!read_all(fd, &length, sizeof(length))) {
+        return false;
+    }
+    field.resize(length);
+    return read_all(fd, &field[0], length);
+}
+
+bool write_list(int fd, const std::vector<std::string>& fields) {
+    if (!write_field(fd, std::to_string(fields.size()))) {
+        return false;
+    }
+    for (const auto& field : fields) {
+        if (!write_field(fd, field)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool read_list(int fd, std::vector<std::string>& fields) {
+    std::string count;
+    if (!read_field(fd, count)) {
+        return false;
+    }
+    fields.resize(std::strtoul(count.c_str(), nullptr, 10));
+    for (auto& field : fields) {
+        if (!read_field(fd, field)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool make_address(const std::string& socket_path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    return true;
+}
+
+// The socket's directory must be ours and writable by nobody else, or another
+// user could put a socket of their own in its place. The server creates it.
+bool check_socket_directory(const std::string& socket_path, bool create, std::string& error) {
+    std::string directory = std::filesystem::path(socket_path).parent_path().string();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    if (create && mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+        error = "could not create " + directory + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (lstat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+        error = directory + " is not a directory";
+        return false;
+    }
+    if (info.st_uid != getuid() || (info.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+        error = directory + " must belong to the current user and be writable only by them";
+        return false;
+    }
+    return true;
+}
+
+// Requests run compilations as the server's user, so both ends must be the same user
+bool peer_is_current_user(int fd) {
+    ucred credentials;
+    socklen_t size = sizeof(credentials);
+    return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) == 0 && credentials.uid == getuid();
+}
+
+// Handle one request: [working_dir][args...] -> [exit_code][log][errors][outputs...]
+void serve_connection(int fd) {
+    std::string working_dir;
+    std::vector<std::string> args;
+    if (!read_field(fd, working_dir) || !read_list(fd, args)) {
+        close(fd);
+        return;
+    }
+
+    InvocationResult result;
+    Invocation invocation;
+    std::string error;
+    if (!parse_arguments(args, working_dir, invocation, error)) {
+        result.exit_code = 1;
+        result.errors = "Error: " + error + "\n";
+    } else {
+        result = run_invocation(invocation);
+    }
+
+    // If the client went away there is nobody left to report a failed send to
+    write_field(fd, std::to_string(result.exit_code)) &&
+        write_field(fd, result.log) &&
+        write_field(fd, result.errors) &&
+        write_list(fd, result.output_files);
+    close(fd);
+}
+
+} // namespace
+
+std::string default_socket_path() {
+    const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir && runtime_dir[0] == '/') {
+        return std::string(runtime_dir) + "/risc.sock";
+    }
+    return "/tmp/risc-" + std::to_string(getuid()) + "/server.sock";
+}
+
+int run_server(const std::string& socket_path, bool verbose) {
+    sockaddr_un address;
+    if (!make_address(socket_path, address)) {
+        std::cerr << "Error: socket path is too long: " << socket_path << std::endl;
+        return 1;
+    }
+
+    std::string error;
+    if (!check_socket_directory(socket_path, true, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    // A socket file left behind by a previous server would make bind() fail;
+    // anything else at that path is not ours to remove
+    struct stat existing;
+    if (lstat(socket_path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode) || existing.st_uid != getuid()) {
+            std::cerr << "Error: " << socket_path << " exists and is not a socket of ours" << std::endl;
+            return 1;
+        }
+        unlink(socket_path.c_str());
+    }
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        std::cerr << "Error: could not create socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0) {
+        std::cerr << "Error: could not listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        return 1;
+    }
+
+    // Pay for LLVM target initialization once, before the first request arrives
+    CodeGenerator warm_up;
+
+    if (verbose) {
+        std::cout << "risc server listening on " << socket_path << std::endl;
+    }
+
+    ThreadPool pool;
+    while (true) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        if (!peer_is_current_user(fd)) {
+            close(fd);
+            continue;
+        }
+        pool.submit([fd]() { serve_connection(fd); });
+    }
+
+    pool.wait();
+    close(listen_fd);
+    unlink(socket_path.c_str());
+    return 1;
+}
+
+bool run_client(const std::string& socket_path, const std::vector<std::string>& args,
+                const std::string& working_dir, InvocationResult& result) {
+    sockaddr_un address;
+    std::string error;
+    if (!make_address(socket_path, address) || !check_socket_directory(socket_path, false, error)) {
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || !peer_is_current_user(fd)) {
+        close(fd);
+        return false;
+    }
+
+    std::string exit_code;
+    InvocationResult reply;
+    bool ok = write_field(fd, working_dir) &&
+              write_list(fd, args) &&
+              read_field(fd, exit_code) &&
+              read_field(fd, reply.log) &&
+              read_field(fd, reply.errors) &&
+              read_list(fd, reply.output_files);
+    close(fd);
+
+    if (!ok) {
+        return false;
+    }
+
+    reply.exit_code = std::atoi(exit_code.c_str());
+    result = reply;
+    return true;
+}
+
+} // namespace ris
@@ -1,10 +1,90 @@
 #include "std.h"
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <string>
 
+// Allocations never return null: generated code relies on it (the
+// declarations carry `nonnull`), so running out of memory is fatal
+static void* checked_malloc(size_t size) {
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        std::fputs("ris: out of memory\n", stderr);
+        std::abort();
+    }
+    return ptr;
+}
+
+// Bytes for `count` items of `size` bytes; a count that does not fit is as
+// fatal as running out of memory
+static size_t checked_bytes(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        std::fputs("ris: list too large\n", stderr);
+        std::abort();
+    }
+    return count * size;
+}
+
+// Sizes arrive as the program's signed int, so a huge one was negative there
+static void check_list_size(size_t size) {
+    if (size > static_cast<size_t>(INT64_MAX)) {
+        std::fputs("ris: negative list size\n", stderr);
+        std::abort();
+    }
+}
+
+// Bytes per cell for scalar elements; 0 for strings and lists, which are
+// stored in the slot itself
+static size_t cell_size(type_tag_t element_type) {
+    switch (element_type) {
+        case TYPE_INT:
+        case TYPE_FLOAT:
+            return 8;
+        case TYPE_BOOL:
+        case TYPE_CHAR:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// One block of cells for `count` new elements, each slot pointing into it.
+// Cell i of the header only ever backs slot i, so the first elements reuse it
+static char* allocate_cells(ris_list_t* list, size_t start, size_t count, size_t element_size) {
+    char* cells = start + count <= RIS_LIST_INLINE_CAPACITY
+                      ? reinterpret_cast<char*>(list->inline_cells) + start * element_size
+                      : static_cast<char*>(checked_malloc(checked_bytes(count, element_size)));
+    for (size_t i = 0; i < count; ++i) {
+        list->data[start + i] = cells + i * element_size;
+    }
+    return cells;
+}
+
+// Move the slots to a block of `capacity`, leaving the inline buffer on first growth
+static void set_capacity(ris_list_t* list, size_t capacity) {
+    if (list->data == list->inline_slots) {
+        void** data = static_cast<void**>(checked_malloc(checked_bytes(capacity, sizeof(void*))));
+        std::memcpy(data, list->inline_slots, list->size * sizeof(void*));
+        list->data = data;
+    } else {
+        list->data = static_cast<void**>(std::realloc(list->data, checked_bytes(capacity, sizeof(void*))));
+        if (!list->data) {
+            std::fputs("ris: out of memory\n", stderr);
+            std::abort();
+        }
+    }
+    list->capacity = capacity;
+}
+
+// Compiled programs run their global initializers from a constructor, and
+// their objects come before this library on the link line. Setting up the
+// streams at a higher priority lets those initializers print.
+__attribute__((constructor(101))) static void init_streams() {
+    static std::ios_base::Init streams;
+}
+
 extern "C" {
 
 // Generic print function (like Python's print)
@@ -64,7 +144,7 @@ void print_with_space(type_tag_t type, const void* value) {
 }
 
 void* ris_malloc(size_t size) {
-    return std::malloc(size);
+    return checked_malloc(size);
 }
 
 void ris_free(void* ptr) {
@@ -81,11 +161,9 @@ char* ris_string_concat(const char* str1, const char* str2) {
     size_t len2 = std::strlen(str2);
     size_t total_len = len1 + len2 + 1;
     
-    char* result = static_cast<char*>(std::malloc(total_len));
-    if (result) {
-        std::strcpy(result, str1);
-        std::strcat(result, str2);
-    }
+    char* result = static_cast<char*>(checked_malloc(total_len));
+    std::memcpy(result, str1, len1);
+    std::memcpy(result + len1, str2, len2 + 1);
     
     return result;
 }
@@ -100,33 +178,175 @@ void ris_exit(int32_t code) {
 
 // List functions
 ris_list_t* ris_list_create(type_tag_t element_type, size_t initial_capacity) {
-    ris_list_t* list = static_cast<ris_list_t*>(std::malloc(sizeof(ris_list_t)));
-    if (!list) return nullptr;
-    
-    list->data = static_cast<void**>(std::malloc(initial_capacity * sizeof(void*)));
-    if (!list->data) {
-        std::free(list);
-        return nullptr;
+    ris_list_t* list = static_cast<ris_list_t*>(checked_malloc(sizeof(ris_list_t)));
+    ris_list_init(list, element_type, initial_capacity);
+    return list;
+}
+
+void ris_list_init(ris_list_t* list, type_tag_t element_type, size_t initial_capacity) {
+    // Short lists need no allocation beyond the header
+    if (initial_capacity <= RIS_LIST_INLINE_CAPACITY) {
+        initial_capacity = RIS_LIST_INLINE_CAPACITY;
+        list->data = list->inline_slots;
+    } else {
+        list->data = static_cast<void**>(checked_malloc(checked_bytes(initial_capacity, sizeof(void*))));
     }
     
     list->size = 0;
     list->capacity = initial_capacity;
     list->element_type = element_type;
+}
+
+ris_list_t* ris_list_from_array(type_tag_t element_type, const void* elements, size_t count) {
+    ris_list_t* list = static_cast<ris_list_t*>(checked_malloc(sizeof(ris_list_t)));
+    ris_list_init_from_array(list, element_type, elements, count);
     return list;
 }
 
+void ris_list_init_from_array(ris_list_t* list, type_tag_t element_type, const void* elements, size_t count) {
+    ris_list_init(list, element_type, count);
+    list->size = count;
+    
+    // Strings and nested lists are stored as the pointers themselves
+    size_t element_size = cell_size(element_type);
+    if (element_size == 0) {
+        std::memcpy(list->data, elements, count * sizeof(void*));
+        return;
+    }
+    
+    // Scalars get one cell block for the whole literal instead of a cell each
+    std::memcpy(allocate_cells(list, 0, count, element_size), elements, count * element_size);
+}
+
 void ris_list_free(ris_list_t* list) {
     if (!list) return;
     
-    // Free all elements
-    for (size_t i = 0; i < list->size; ++i) {
-        if (list->data[i]) {
-            std::free(list->data[i]);
+    // Elements are not owned by the list: strings may be literals, nested
+    // lists may be shared, and cells from ris_list_from_array share a block
+    if (list->data != list->inline_slots) {
+        std::free(list->data);
+    }
+    std::free(list);
+}
+
+void ris_list_reserve(ris_list_t* list, size_t capacity) {
+    check_list_size(capacity);
+    if (!list || capacity <= list->capacity) return;
+    set_capacity(list, capacity);
+}
+
+void ris_list_resize(ris_list_t* list, size_t size, type_tag_t element_type, const void* value) {
+    check_list_size(size);
+    if (!list) return;
+    if (size <= list->size) {
+        list->size = size;
+        return;
+    }
+    
+    ris_list_reserve(list, size);
+    size_t start = list->size;
+    size_t count = size - start;
+    size_t element_size = cell_size(element_type);
+    if (element_size == 0) {
+        void* element = *static_cast<void* const*>(value);
+        for (size_t i = start; i < size; ++i) {
+            list->data[i] = element;
+        }
+    } else if (element_size == 1) {
+        std::memset(allocate_cells(list, start, count, 1), *static_cast<const unsigned char*>(value), count);
+    } else {
+        // Copy the first cell, then double the filled prefix
+        char* cells = allocate_cells(list, start, count, element_size);
+        std::memcpy(cells, value, element_size);
+        for (size_t filled = 1; filled < count; filled *= 2) {
+            size_t chunk = filled < count - filled ? filled : count - filled;
+            std::memcpy(cells + filled * element_size, cells, chunk * element_size);
         }
     }
+    list->size = size;
+}
+
+void ris_list_fill(ris_list_t* list, type_tag_t element_type, const void* value) {
+    if (!list) return;
     
-    std::free(list->data);
-    std::free(list);
+    // Existing cells are overwritten in place, so nothing is allocated
+    size_t element_size = cell_size(element_type);
+    if (element_size == 0) {
+        void* element = *static_cast<void* const*>(value);
+        for (size_t i = 0; i < list->size; ++i) {
+            list->data[i] = element;
+        }
+    } else {
+        for (size_t i = 0; i < list->size; ++i) {
+            std::memcpy(list->data[i], value, element_size);
+        }
+    }
+}
+
+void ris_list_clear(ris_list_t* list) {
+    if (list) {
+        list->size = 0;
+    }
+}
+
+void ris_list_extend(ris_list_t* list, type_tag_t element_type, const ris_list_t* other) {
+    if (!list || !other || other->size == 0) return;
+    
+    // `xs.extend(xs)` reads the slots after they may have moved
+    size_t start = list->size;
+    size_t count = other->size;
+    ris_list_reserve(list, start + count);
+    
+    // Scalars are copied into cells of their own, so the lists never share an element
+    size_t element_size = cell_size(element_type);
+    if (element_size == 0) {
+        std::memcpy(list->data + start, other->data, count * sizeof(void*));
+    } else {
+        char* cells = allocate_cells(list, start, count, element_size);
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(cells + i * element_size, other->data[i], element_size);
+        }
+    }
+    list->size = start + count;
+}
+
+ris_list_t* ris_list_copy(const ris_list_t* list, type_tag_t element_type) {
+    if (!list) {
+        return ris_list_create(element_type, 0);
+    }
+    ris_list_t* copy = ris_list_create(list->element_type, list->size);
+    ris_list_extend(copy, element_type, list);
+    return copy;
+}
+
+int8_t ris_list_equal(const ris_list_t* a, const ris_list_t* b, type_tag_t element_type) {
+    if (a == b) return 1;
+    if (!a || !b || a->size != b->size) return 0;
+    
+    for (size_t i = 0; i < a->size; ++i) {
+        const void* x = a->data[i];
+        const void* y = b->data[i];
+        bool same;
+        switch (element_type) {
+            case TYPE_FLOAT:
+                same = *static_cast<const double*>(x) == *static_cast<const double*>(y);
+                break;
+            case TYPE_STRING:
+                same = std::strcmp(x ? static_cast<const char*>(x) : "", y ? static_cast<const char*>(y) : "") == 0;
+                break;
+            case TYPE_LIST: {
+                // Nested lists compare with the element type they were created with
+                const ris_list_t* inner = static_cast<const ris_list_t*>(x);
+                same = ris_list_equal(inner, static_cast<const ris_list_t*>(y), inner ? inner->element_type : TYPE_INT);
+                break;
+            }
+            default:
+                same = std::memcmp(x, y, cell_size(element_type)) == 0;
+                break;
+        }
+        if (!same) return 0;
+    }
+    return 1;
 }
 
 void ris_list_push(ris_list_t* list, void* element) {
@@ -134,17 +354,29 @@ void ris_list_push(ris_list_t* list, void* element) {
     
     // Resize if needed
     if (list->size >= list->capacity) {
-        size_t new_capacity = list->capacity * 2;
-        void** new_data = static_cast<void**>(std::realloc(list->data, new_capacity * sizeof(void*)));
-        if (!new_data) return; // Out of memory
-        list->data = new_data;
-        list->capacity = new_capacity;
+        set_capacity(list, list->capacity * 2);
     }
     
     list->data[list->size] = element;
     list->size++;
 }
 
+void ris_list_push_value(ris_list_t* list, type_tag_t element_type, const void* value) {
+    if (!list) return;
+    
+    size_t element_size = cell_size(element_type);
+    if (element_size == 0) {
+        ris_list_push(list, *static_cast<void* const*>(value));
+        return;
+    }
+    
+    if (list->size >= list->capacity) {
+        set_capacity(list, list->capacity * 2);
+    }
+    std::memcpy(allocate_cells(list, list->size, 1, element_size), value, element_size);
+    list->size++;
+}
+
 void* ris_list_pop(ris_list_t* list) {
     if (!list || list->size == 0) return nullptr;
     
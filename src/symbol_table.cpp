@@ -66,6 +66,10 @@ SymbolTable::SymbolTable() {
     enter_scope();
 }
 
+SymbolTable::SymbolTable(Scope* parent) {
+    scopes_.push_back(std::make_unique<Scope>(parent));
+}
+
 void SymbolTable::enter_scope() {
     Scope* parent = scopes_.empty() ? nullptr : scopes_.back().get();
     scopes_.push_back(std::make_unique<Scope>(parent));
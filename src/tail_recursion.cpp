@@ -0,0 +1,146 @@
+#include "tail_recursion.h"
+#include <algorithm>
+
+namespace ris {
+
+namespace {
+
+// Finds the self tail calls of one function and checks that its body can be
+// wrapped in a loop without changing what break/continue/names refer to
+class TailCallFinder {
+public:
+    explicit TailCallFinder(const FuncDecl& func) : func_(func) {}
+
+    std::vector<std::unique_ptr<Stmt>*> sites; // Owning slots of the rewritable returns
+    bool wrappable = true;
+
+    void visit(std::unique_ptr<Stmt>& slot, bool nested) {
+        Stmt* stmt = slot.get();
+        if (!stmt) {
+            return;
+        }
+
+        if (auto* block = dynamic_cast<BlockStmt*>(stmt)) {
+            for (auto& child : block->statements) {
+                visit(child, nested);
+            }
+        } else if (auto* if_stmt = dynamic_cast<IfStmt*>(stmt)) {
+            visit(if_stmt->then_branch, nested);
+            visit(if_stmt->else_branch, nested);
+        } else if (auto* while_stmt = dynamic_cast<WhileStmt*>(stmt)) {
+            visit(while_stmt->body, true);
+        } else if (auto* for_stmt = dynamic_cast<ForStmt*>(stmt)) {
+            if (for_stmt->init && is_parameter(for_stmt->init->name)) {
+                wrappable = false;
+            }
+            visit(for_stmt->body, true);
+        } else if (auto* switch_stmt = dynamic_cast<SwitchStmt*>(stmt)) {
+            for (auto& case_stmt : switch_stmt->cases) {
+                for (auto& child : case_stmt->statements) {
+                    visit(child, true);
+                }
+            }
+        } else if (auto* var = dynamic_cast<VarDecl*>(stmt)) {
+            // Locals share one namespace with the parameters in codegen
+            if (is_parameter(var->name)) {
+                wrappable = false;
+            }
+        } else if (dynamic_cast<BreakStmt*>(stmt) || dynamic_cast<ContinueStmt*>(stmt)) {
+            // Would bind to the new loop instead of being rejected
+            if (!nested) {
+                wrappable = false;
+            }
+        } else if (auto* ret = dynamic_cast<ReturnStmt*>(stmt)) {
+            auto* call = dynamic_cast<CallExpr*>(ret->value.get());
+            if (!nested && call && call->function_name == func_.name &&
+                call->arguments.size() == func_.parameters.size()) {
+                sites.push_back(&slot);
+            }
+        }
+    }
+
+private:
+    const FuncDecl& func_;
+
+    bool is_parameter(const std::string& name) const {
+        return std::any_of(func_.parameters.begin(), func_.parameters.end(),
+                           [&](const std::pair<std::string, std::string>& param) { return param.second == name; });
+    }
+};
+
+// `return f(a, b)` -> `{ T0 tail.0 = a; T1 tail.1 = b; p0 = tail.0; p1 = tail.1; continue; }`
+// Every argument is evaluated before any parameter changes, as in the call.
+// The temporaries' names cannot clash with user identifiers.
+std::unique_ptr<Stmt> make_jump(const FuncDecl& func, ReturnStmt& ret) {
+    auto* call = static_cast<CallExpr*>(ret.value.get());
+    SourcePos pos = ret.position;
+    auto block = std::make_unique<BlockStmt>(pos);
+
+    std::vector<size_t> changed;
+    for (size_t i = 0; i < func.parameters.size(); ++i) {
+        // f(n - 1, acc) leaves acc alone
+        auto* same = dynamic_cast<IdentifierExpr*>(call->arguments[i].get());
+        if (same && same->name == func.parameters[i].second) {
+            continue;
+        }
+        auto temp = std::make_unique<VarDecl>("tail." + std::to_string(i), func.parameters[i].first, pos);
+        temp->initializer = std::move(call->arguments[i]);
+        block->statements.push_back(std::move(temp));
+        changed.push_back(i);
+    }
+
+    for (size_t i : changed) {
+        auto assign = std::make_unique<BinaryExpr>(std::make_unique<IdentifierExpr>(func.parameters[i].second, pos),
+                                                   std::make_unique<IdentifierExpr>("tail." + std::to_string(i), pos),
+                                                   TokenType::ASSIGN, pos);
+        block->statements.push_back(std::make_unique<ExprStmt>(std::move(assign), pos));
+    }
+
+    block->statements.push_back(std::make_unique<ContinueStmt>(pos));
+    return block;
+}
+
+bool rewrite_function(FuncDecl& func) {
+    if (!func.body) {
+        return false;
+    }
+
+    TailCallFinder finder(func);
+    for (auto& stmt : func.body->statements) {
+        finder.visit(stmt, false);
+    }
+    if (!finder.wrappable || finder.sites.empty()) {
+        return false;
+    }
+
+    for (auto* slot : finder.sites) {
+        *slot = make_jump(func, static_cast<ReturnStmt&>(**slot));
+    }
+
+    // Falling off the end of a void function still returns
+    SourcePos pos = func.body->position;
+    auto loop_body = std::move(func.body);
+    if (func.return_type == "void") {
+        loop_body->statements.push_back(std::make_unique<ReturnStmt>(pos));
+    }
+
+    auto loop = std::make_unique<WhileStmt>(std::make_unique<LiteralExpr>("true", TokenType::TRUE, pos), pos);
+    loop->body = std::move(loop_body);
+    func.body = std::make_unique<BlockStmt>(pos);
+    func.body->statements.push_back(std::move(loop));
+    return true;
+}
+
+} // namespace
+
+size_t rewrite_tail_recursion(Program& program) {
+    size_t rewritten = 0;
+    for (auto& func : program.functions) {
+        if (rewrite_function(*func)) {
+            ++rewritten;
+        }
+    }
+    return rewritten;
+}
+
+} // namespace ris
@@ -0,0 +1,93 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace ris {
+
+ThreadPool::ThreadPool(unsigned threads)
+    : pending_(0), stopping_(false) {
+    if (threads == 0) {
+        threads = default_jobs();
+    }
+
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    task_available_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push(std::move(task));
+        pending_++;
+    }
+    task_available_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    all_done_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+unsigned ThreadPool::default_jobs() {
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+void ThreadPool::worker_loop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            task_available_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return; // Stopping and nothing left to do
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_--;
+            if (pending_ == 0) {
+                all_done_.notify_all();
+            }
+        }
+    }
+}
+
+void parallel_for(size_t count, unsigned jobs, const std::function<void(size_t)>& body) {
+    if (jobs == 0) {
+        jobs = ThreadPool::default_jobs();
+    }
+
+    if (count <= 1 || jobs <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    ThreadPool pool(static_cast<unsigned>(std::min<size_t>(jobs, count)));
+    for (size_t i = 0; i < count; ++i) {
+        pool.submit([&body, i]() { body(i); });
+    }
+    pool.wait();
+}
+
+} // namespace ris
@@ -20,6 +20,7 @@ bool Token::is_keyword() const {
         case TokenType::RETURN:
         case TokenType::TRUE:
         case TokenType::FALSE:
+        case TokenType::CONST:
             return true;
         default:
             return false;
@@ -55,6 +56,11 @@ bool Token::is_operator() const {
         case TokenType::OR:
         case TokenType::NOT:
         case TokenType::ASSIGN:
+        case TokenType::PLUS_ASSIGN:
+        case TokenType::MINUS_ASSIGN:
+        case TokenType::MULTIPLY_ASSIGN:
+        case TokenType::DIVIDE_ASSIGN:
+        case TokenType::MODULO_ASSIGN:
             return true;
         default:
             return false;
@@ -66,6 +72,7 @@ bool Token::is_punctuation() const {
         case TokenType::SEMICOLON:
         case TokenType::COMMA:
         case TokenType::DOT:
+        case TokenType::AT:
         case TokenType::LEFT_PAREN:
         case TokenType::RIGHT_PAREN:
         case TokenType::LEFT_BRACE:
@@ -105,6 +112,7 @@ TokenType keyword_to_token_type(const std::string& keyword) {
     if (keyword == "return") return TokenType::RETURN;
     if (keyword == "true") return TokenType::TRUE;
     if (keyword == "false") return TokenType::FALSE;
+    if (keyword == "const") return TokenType::CONST;
     if (keyword == "include") return TokenType::INCLUDE;
     return TokenType::IDENTIFIER;
 }
@@ -136,6 +144,7 @@ std::string token_type_to_string(TokenType type) {
         case TokenType::RETURN: return "RETURN";
         case TokenType::TRUE: return "TRUE";
         case TokenType::FALSE: return "FALSE";
+        case TokenType::CONST: return "CONST";
         case TokenType::PLUS: return "PLUS";
         case TokenType::MINUS: return "MINUS";
         case TokenType::MULTIPLY: return "MULTIPLY";
@@ -151,11 +160,17 @@ std::string token_type_to_string(TokenType type) {
         case TokenType::OR: return "OR";
         case TokenType::NOT: return "NOT";
         case TokenType::ASSIGN: return "ASSIGN";
+        case TokenType::PLUS_ASSIGN: return "PLUS_ASSIGN";
+        case TokenType::MINUS_ASSIGN: return "MINUS_ASSIGN";
+        case TokenType::MULTIPLY_ASSIGN: return "MULTIPLY_ASSIGN";
+        case TokenType::DIVIDE_ASSIGN: return "DIVIDE_ASSIGN";
+        case TokenType::MODULO_ASSIGN: return "MODULO_ASSIGN";
         case TokenType::INCREMENT: return "INCREMENT";
         case TokenType::SEMICOLON: return "SEMICOLON";
         case TokenType::COMMA: return "COMMA";
         case TokenType::DOT: return "DOT";
         case TokenType::COLON: return "COLON";
+        case TokenType::AT: return "AT";
         case TokenType::LEFT_PAREN: return "LEFT_PAREN";
         case TokenType::RIGHT_PAREN: return "RIGHT_PAREN";
         case TokenType::LEFT_BRACE: return "LEFT_BRACE";
@@ -169,4 +184,19 @@ std::string token_type_to_string(TokenType type) {
     }
 }
 
+bool is_assignment_operator(TokenType type) {
+    return type == TokenType::ASSIGN || compound_assignment_operator(type) != TokenType::ASSIGN;
+}
+
+TokenType compound_assignment_operator(TokenType type) {
+    switch (type) {
+        case TokenType::PLUS_ASSIGN: return TokenType::PLUS;
+        case TokenType::MINUS_ASSIGN: return TokenType::MINUS;
+        case TokenType::MULTIPLY_ASSIGN: return TokenType::MULTIPLY;
+        case TokenType::DIVIDE_ASSIGN: return TokenType::DIVIDE;
+        case TokenType::MODULO_ASSIGN: return TokenType::MODULO;
+        default: return TokenType::ASSIGN;
+    }
+}
+
 } // namespace ris
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include "cache.h"
+#include "lexer.h"
+
+#define ASSERT_TRUE(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << " FAIL  " #condition " is false at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+#define ASSERT_FALSE(condition) \
+    do { \
+        if (condition) { \
+            std::cerr << " FAIL  " #condition " is true at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+static std::string token_digest(const std::string& code) {
+    ris::Lexer lexer(code);
+    ris::CacheKey key;
+    key.add_tokens(lexer.tokenize());
+    return key.digest();
+}
+
+int test_cache_key_and_store() {
+    std::cout << "Running test_cache_key_and_store .........";
+    
+    // Layout and comments do not change the key, code does
+    std::string base = token_digest("int main() { return 0; }");
+    ASSERT_TRUE(base == token_digest("int main() {\n    // done\n    return 0;\n}"));
+    ASSERT_FALSE(base == token_digest("int main() { return 1; }"));
+    
+    std::string directory = "test_cache_dir";
+    ris::CompileCache cache(directory);
+    ASSERT_FALSE(cache.fetch(base, "test_cache_out"));
+    
+    {
+        std::ofstream artifact("test_cache_artifact");
+        artifact << "binary";
+    }
+    cache.store(base, "test_cache_artifact");
+    ASSERT_TRUE(cache.fetch(base, "test_cache_out"));
+    
+    std::ifstream fetched("test_cache_out");
+    std::string contents;
+    fetched >> contents;
+    fetched.close();
+    
+    std::filesystem::remove_all(directory);
+    std::filesystem::remove("test_cache_artifact");
+    std::filesystem::remove("test_cache_out");
+    
+    ASSERT_TRUE(contents == "binary");
+    
+    return 0;
+}
+
+int test_cache_eviction() {
+    std::cout << "Running test_cache_eviction .........";
+    
+    // Room for two six-byte entries, not three
+    std::string directory = "test_cache_evict_dir";
+    ris::CompileCache cache(directory, 12);
+    {
+        std::ofstream artifact("test_cache_artifact");
+        artifact << "binary";
+    }
+    
+    auto age = [&](const std::string& key, int hours) {
+        std::filesystem::last_write_time(std::filesystem::path(directory) / key,
+                                         std::filesystem::file_time_type::clock::now() - std::chrono::hours(hours));
+    };
+    cache.store("old", "test_cache_artifact");
+    age("old", 2);
+    cache.store("used", "test_cache_artifact");
+    age("used", 3);
+    
+    // A hit counts as a use, so the entry stored first is the one to go
+    ASSERT_TRUE(cache.fetch("used", "test_cache_out"));
+    cache.store("new", "test_cache_artifact");
+    
+    bool old_kept = std::filesystem::exists(std::filesystem::path(directory) / "old");
+    bool used_kept = std::filesystem::exists(std::filesystem::path(directory) / "used");
+    bool new_kept = std::filesystem::exists(std::filesystem::path(directory) / "new");
+    
+    std::filesystem::remove_all(directory);
+    std::filesystem::remove("test_cache_artifact");
+    std::filesystem::remove("test_cache_out");
+    
+    ASSERT_FALSE(old_kept);
+    ASSERT_TRUE(used_kept);
+    ASSERT_TRUE(new_kept);
+    
+    return 0;
+}
+
+// Test functions are defined above, main() is in test_runner.cpp
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <cstdio>
+#include <vector>
 #include "lexer.h"
 #include "parser.h"
 #include "semantic_analyzer.h"
@@ -57,6 +59,30 @@ bool check_file_contains(const std::string& filename, const std::string& expecte
     return content.find(expected) != std::string::npos;
 }
 
+// Function attributes of a declaration, from the attribute group it refers to
+static std::string declaration_attributes(const std::string& filename, const std::string& function) {
+    std::ifstream file(filename);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    
+    std::string group;
+    for (const auto& declaration : lines) {
+        if (declaration.compare(0, 8, "declare ") == 0 && declaration.find("@" + function + "(") != std::string::npos) {
+            group = declaration.substr(declaration.rfind(" #") + 1);
+        }
+    }
+    for (const auto& attributes : lines) {
+        std::string prefix = "attributes " + group + " = { ";
+        if (!group.empty() && attributes.compare(0, prefix.size(), prefix) == 0) {
+            return attributes.substr(prefix.size(), attributes.size() - prefix.size() - 2);
+        }
+    }
+    return "";
+}
+
 int test_codegen_basic_function() {
     std::string code = "int main() { return 42; }";
     std::string output_file;
@@ -73,7 +99,7 @@ int test_codegen_void_function() {
     std::string output_file;
     
     ASSERT_TRUE(compile_code(code, output_file));
-    ASSERT_TRUE(check_file_contains(output_file, "define void @test()"));
+    ASSERT_TRUE(check_file_contains(output_file, "define internal fastcc void @test()"));
     ASSERT_TRUE(check_file_contains(output_file, "ret void"));
     return 0;
 }
@@ -85,7 +111,7 @@ int test_codegen_function_with_parameters() {
     std::string output_file;
     
     ASSERT_TRUE(compile_code(code, output_file));
-    ASSERT_TRUE(check_file_contains(output_file, "define i64 @add(i64"));
+    ASSERT_TRUE(check_file_contains(output_file, "define internal fastcc i64 @add(i64"));
     
     
     return 0;
@@ -160,6 +186,358 @@ int test_codegen_error_handling() {
     return 0;
 }
 
+int test_codegen_parallel_objects() {
+    std::cout << "Running test_codegen_parallel_objects .........";
+    
+    std::string code = "int g = 3; int one() { return g; } int two() { return one() + 1; } int main() { return two(); }";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    ris::CodeGenOptions options;
+    options.jobs = 2;
+    ris::CodeGenerator codegen(options);
+    std::vector<std::string> object_files;
+    ASSERT_TRUE(codegen.generate_objects(std::move(program), "test_parallel", object_files));
+    ASSERT_TRUE(object_files.size() == 2);
+    
+    for (const auto& object_file : object_files) {
+        std::ifstream file(object_file);
+        ASSERT_TRUE(file.is_open());
+        std::remove(object_file.c_str());
+    }
+    
+    return 0;
+}
+
+int test_codegen_target_cpu() {
+    std::cout << "Running test_codegen_target_cpu .........";
+    
+    std::string code = "int main() { return 0; }";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    ris::CodeGenOptions options;
+    options.target_cpu = "native";
+    ris::CodeGenerator codegen(options);
+    std::string output_file = "test_target_cpu.ll";
+    ASSERT_TRUE(codegen.generate(std::move(program), output_file));
+    
+    std::string cpu, features;
+    ris::CodeGenerator::resolve_target(options, cpu, features);
+    ASSERT_TRUE(cpu != "native");
+    ASSERT_TRUE(check_file_contains(output_file, "\"target-cpu\"=\"" + cpu + "\""));
+    std::remove(output_file.c_str());
+    
+    // Explicit features are appended after the host's so they win
+    options.target_features = "-avx2";
+    ris::CodeGenerator::resolve_target(options, cpu, features);
+    ASSERT_TRUE(features.size() >= 5 && features.compare(features.size() - 5, 5, "-avx2") == 0);
+    
+    return 0;
+}
+
+int test_codegen_whole_program() {
+    std::cout << "Running test_codegen_whole_program .........";
+    
+    std::string code = "int twice(int x) { return x + x; } int main() { return twice(2); }";
+    std::string output_file;
+    ASSERT_TRUE(compile_code(code, output_file));
+    ASSERT_TRUE(check_file_contains(output_file, "define i64 @main()"));
+    ASSERT_TRUE(check_file_contains(output_file, "define internal fastcc i64 @twice(i64"));
+    ASSERT_TRUE(check_file_contains(output_file, "call fastcc i64 @twice("));
+    
+    // Opting out keeps helpers callable from other objects
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    ris::CodeGenOptions options;
+    options.whole_program = false;
+    ris::CodeGenerator codegen(options);
+    ASSERT_TRUE(codegen.generate(std::move(program), output_file));
+    ASSERT_TRUE(check_file_contains(output_file, "define i64 @twice(i64"));
+    
+    return 0;
+}
+
+int test_codegen_short_circuit() {
+    std::cout << "Running test_codegen_short_circuit .........";
+    
+    std::string code = "int check(int x) { return x + 1; } "
+                       "int main() { int i = 0; if (i < 3 && check(i) > 1) { return 1; } bool b = i == 0 || check(i) > 2; return 0; }";
+    std::string output_file;
+    ASSERT_TRUE(compile_code(code, output_file));
+    
+    // The call sits behind a branch, and the branch condition is the PHI itself
+    ASSERT_TRUE(check_file_contains(output_file, "and.rhs:"));
+    ASSERT_TRUE(check_file_contains(output_file, "%andtmp = phi i1 [ false, %entry ]"));
+    ASSERT_TRUE(check_file_contains(output_file, "br i1 %andtmp"));
+    ASSERT_TRUE(check_file_contains(output_file, "%ortmp = phi i1 [ true, "));
+    ASSERT_FALSE(check_file_contains(output_file, " and i"));
+    
+    return 0;
+}
+
+int test_codegen_runtime_attributes() {
+    std::cout << "Running test_codegen_runtime_attributes .........";
+    
+    std::string code = "int main() { return 0; }";
+    std::string output_file;
+    ASSERT_TRUE(compile_code(code, output_file));
+    
+    ASSERT_TRUE(check_file_contains(output_file, "declare noalias nonnull ptr @ris_malloc(i64)"));
+    ASSERT_TRUE(check_file_contains(output_file, "declare i64 @ris_list_size(ptr nocapture readonly)"));
+    ASSERT_TRUE(check_file_contains(output_file, "declare i64 @ris_list_get_int(ptr nocapture readonly, i64)"));
+    // These may hand out or store a pointer to the header's inline cells
+    ASSERT_TRUE(check_file_contains(output_file, "declare ptr @ris_list_get(ptr readonly, i64)"));
+    ASSERT_TRUE(check_file_contains(output_file, "declare ptr @ris_list_pop(ptr)"));
+    ASSERT_TRUE(check_file_contains(output_file, "declare void @ris_list_push_value(ptr, i32, ptr nocapture readonly)"));
+    ASSERT_TRUE(check_file_contains(output_file, "declare void @ris_list_extend(ptr, i32, ptr nocapture readonly)"));
+    ASSERT_TRUE(check_file_contains(output_file, "noreturn nounwind"));
+    // Anything that allocates may abort, so it is not willreturn
+    ASSERT_TRUE(declaration_attributes(output_file, "ris_list_reserve") == "nounwind");
+    ASSERT_TRUE(declaration_attributes(output_file, "ris_list_resize") == "nounwind");
+    ASSERT_TRUE(declaration_attributes(output_file, "ris_list_push_value") == "nounwind");
+    ASSERT_TRUE(declaration_attributes(output_file, "ris_list_init") == "nounwind");
+    ASSERT_TRUE(declaration_attributes(output_file, "ris_list_fill") == "nounwind willreturn");
+    
+    return 0;
+}
+
+int test_codegen_list_tbaa() {
+    std::cout << "Running test_codegen_list_tbaa .........";
+    
+    std::string code = "int main() { list<int> a = [1, 2, 3]; int x = a[1]; return x; }";
+    std::string output_file;
+    ASSERT_TRUE(compile_code(code, output_file));
+    
+    // The element is read inline, not through ris_list_get_int
+    ASSERT_FALSE(check_file_contains(output_file, "call i64 @ris_list_get_int"));
+    ASSERT_TRUE(check_file_contains(output_file, "!tbaa"));
+    ASSERT_TRUE(check_file_contains(output_file, "!\"ris list header\""));
+    ASSERT_TRUE(check_file_contains(output_file, "!\"ris list slots\""));
+    ASSERT_TRUE(check_file_contains(output_file, "!\"ris int element\""));
+    
+    return 0;
+}
+
+int test_codegen_arithmetic_modes() {
+    std::cout << "Running test_codegen_arithmetic_modes .........";
+    
+    std::string code = "float mix(float a, float b, float c) { return a * b + c; } "
+                       "int bump(int x) { return x * 3 + 1; } int main() { return 0; }";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    ris::CodeGenOptions options;
+    options.opt_level = 0;
+    options.fast_math = true;
+    options.no_signed_wrap = true;
+    ris::CodeGenerator codegen(options);
+    std::string output_file = "test_arithmetic_modes.ll";
+    ASSERT_TRUE(codegen.generate(std::move(program), output_file));
+    
+    ASSERT_TRUE(check_file_contains(output_file, "fmul fast double"));
+    ASSERT_TRUE(check_file_contains(output_file, "fadd fast double"));
+    ASSERT_TRUE(check_file_contains(output_file, "mul nsw i64"));
+    ASSERT_TRUE(check_file_contains(output_file, "add nsw i64"));
+    ASSERT_TRUE(check_file_contains(output_file, "\"unsafe-fp-math\"=\"true\""));
+    std::remove(output_file.c_str());
+    
+    ASSERT_TRUE(ris::CodeGenerator::arithmetic_mode(options) != ris::CodeGenerator::arithmetic_mode(ris::CodeGenOptions()));
+    
+    return 0;
+}
+
+int test_codegen_loop_hints() {
+    std::cout << "Running test_codegen_loop_hints .........";
+    
+    std::string code = "int sum(int n) { int s = 0; @unroll(4) @interleave(2) for (int i = 0; i < n; i++) { s = s + i; } "
+                       "@vectorize(width=8) while (s > 100) { s = s - 3; } return s; } int main() { return sum(10); }";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    ris::CodeGenOptions options;
+    options.opt_level = 0;
+    ris::CodeGenerator codegen(options);
+    std::string output_file = "test_loop_hints.ll";
+    ASSERT_TRUE(codegen.generate(std::move(program), output_file));
+    
+    ASSERT_TRUE(check_file_contains(output_file, "!llvm.loop"));
+    ASSERT_TRUE(check_file_contains(output_file, "!{!\"llvm.loop.unroll.count\", i32 4}"));
+    ASSERT_TRUE(check_file_contains(output_file, "!{!\"llvm.loop.interleave.count\", i32 2}"));
+    ASSERT_TRUE(check_file_contains(output_file, "!{!\"llvm.loop.vectorize.width\", i32 8}"));
+    std::remove(output_file.c_str());
+    
+    // Unknown hints and hints on anything but a loop are rejected
+    ASSERT_FALSE(compile_code("int main() { @fast for (int i = 0; i < 3; i++) { } return 0; }", output_file));
+    ASSERT_FALSE(compile_code("int main() { @unroll(0) while (false) { } return 0; }", output_file));
+    ASSERT_FALSE(compile_code("int main() { @unroll return 0; }", output_file));
+    
+    return 0;
+}
+
+int test_codegen_function_hints() {
+    std::cout << "Running test_codegen_function_hints .........";
+    
+    std::string code = "@inline int twice(int x) { return x + x; } "
+                       "@cold @noinline int fail(int code) { return code; } "
+                       "@hot @flatten int run(int x) { if (unlikely(x < 0)) { return fail(x); } return twice(x); } "
+                       "int main() { return run(4); }";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    ris::CodeGenOptions options;
+    options.opt_level = 0;
+    ris::CodeGenerator codegen(options);
+    std::string output_file = "test_function_hints.ll";
+    ASSERT_TRUE(codegen.generate(std::move(program), output_file));
+    
+    ASSERT_TRUE(check_file_contains(output_file, "alwaysinline"));
+    ASSERT_TRUE(check_file_contains(output_file, "noinline"));
+    ASSERT_TRUE(check_file_contains(output_file, "cold"));
+    ASSERT_TRUE(check_file_contains(output_file, "hot"));
+    ASSERT_TRUE(check_file_contains(output_file, "call i1 @llvm.expect.i1(i1 %lttmp, i1 false)"));
+    std::remove(output_file.c_str());
+    
+    ASSERT_FALSE(compile_code("@inline @noinline int f() { return 0; } int main() { return f(); }", output_file));
+    ASSERT_FALSE(compile_code("@noinline int f(); @inline int f() { return 0; } int main() { return f(); }", output_file));
+    ASSERT_FALSE(compile_code("@hot int f(); @cold int f() { return 0; } int main() { return f(); }", output_file));
+    ASSERT_TRUE(compile_code("@noinline int f(); @noinline int f() { return 0; } int main() { return f(); }", output_file));
+    ASSERT_FALSE(compile_code("@fast int main() { return 0; }", output_file));
+    ASSERT_FALSE(compile_code("bool likely(bool b) { return b; } int main() { return 0; }", output_file));
+    
+    return 0;
+}
+
+int test_codegen_list_literal_table() {
+    std::cout << "Running test_codegen_list_literal_table .........";
+    
+    std::string code = "int main() { list<int> a = [1, 2, 3, 4, 5]; list<string> s = [\"x\", \"y\"]; "
+                       "int n = 2; list<int> b = [n, 1]; return a[0] + b[0]; }";
+    std::string output_file;
+    ASSERT_TRUE(compile_code(code, output_file));
+    
+    // Literal elements become one read-only array and one runtime call
+    ASSERT_TRUE(check_file_contains(output_file, "@list.table = private unnamed_addr constant [5 x i64] [i64 1, i64 2, i64 3, i64 4, i64 5]"));
+    ASSERT_TRUE(check_file_contains(output_file, "constant [2 x ptr]"));
+    ASSERT_TRUE(check_file_contains(output_file, "call ptr @ris_list_from_array(i32 0, ptr @list.table, i64 5)"));
+    ASSERT_TRUE(check_file_contains(output_file, "call ptr @ris_list_from_array(i32 4, ptr @list.table.1, i64 2)"));
+    
+    // A computed element still goes through push
+    ASSERT_TRUE(check_file_contains(output_file, "call void @ris_list_push"));
+    
+    return 0;
+}
+
+int test_codegen_list_element_store() {
+    std::cout << "Running test_codegen_list_element_store .........";
+    
+    std::string code = "void step(list<int> xs, int i) { xs[i] = 3; xs[i] += 2; xs[i]++; } "
+                       "int main() { list<int> a = [1, 2]; step(a, 0); int x = 7; x %= 4; return a[0] + x; }";
+    std::string output_file;
+    ASSERT_TRUE(compile_code(code, output_file));
+    
+    // Elements are updated in place through the slot array
+    ASSERT_TRUE(check_file_contains(output_file, "list.store:"));
+    ASSERT_TRUE(check_file_contains(output_file, "%list.old = load i64"));
+    ASSERT_TRUE(check_file_contains(output_file, "store i64 3, ptr %list.slot"));
+    ASSERT_TRUE(check_file_contains(output_file, "srem i64"));
+    
+    ASSERT_FALSE(compile_code("int main() { 1 = 2; return 0; }", output_file));
+    ASSERT_FALSE(compile_code("int main() { list<int> a = [1]; a[0] += \"s\"; return 0; }", output_file));
+    
+    return 0;
+}
+
+int test_codegen_list_bulk_operations() {
+    std::cout << "Running test_codegen_list_bulk_operations .........";
+    
+    std::string code = "int main() { list<int> a = [1, 2]; a.reserve(8); a.resize(4, 0); list<int> b = a.copy(); "
+                       "b.fill(3); a.extend(b); if (a != b) { a.clear(); } return a.size(); }";
+    std::string output_file;
+    ASSERT_TRUE(compile_code(code, output_file));
+    
+    // Each operation is a single runtime call instead of a loop of pushes
+    ASSERT_TRUE(check_file_contains(output_file, "call void @ris_list_reserve"));
+    ASSERT_TRUE(check_file_contains(output_file, "call void @ris_list_resize"));
+    ASSERT_TRUE(check_file_contains(output_file, "call void @ris_list_fill"));
+    ASSERT_TRUE(check_file_contains(output_file, "call void @ris_list_extend"));
+    ASSERT_TRUE(check_file_contains(output_file, "call void @ris_list_clear"));
+    ASSERT_TRUE(check_file_contains(output_file, "@ris_list_copy"));
+    ASSERT_TRUE(check_file_contains(output_file, "@ris_list_equal"));
+    
+    ASSERT_FALSE(compile_code("int main() { list<int> a = [1]; a.fill(\"s\"); return 0; }", output_file));
+    ASSERT_FALSE(compile_code("int main() { list<int> a = [1]; list<float> b = [1.0]; a.extend(b); return 0; }", output_file));
+    ASSERT_FALSE(compile_code("int main() { list<int> a = [1]; a.resize(2); return 0; }", output_file));
+    ASSERT_FALSE(compile_code("int main() { list<int> a = [1]; a.reserve(-1); return 0; }", output_file));
+    ASSERT_FALSE(compile_code("int main() { list<int> a = [1]; a.resize(-2, 0); return 0; }", output_file));
+    
+    return 0;
+}
+
+int test_codegen_list_element_store_types() {
+    std::cout << "Running test_codegen_list_element_store_types .........";
+    
+    std::string code = "void step(list<float> f, list<char> c, list<bool> b) { f[0] = 3; f[1]++; c[5]++; b[0] = true; } "
+                       "int main() { return 0; }";
+    std::string output_file;
+    ASSERT_TRUE(compile_code(code, output_file));
+    
+    // The right side is converted to the element type, and the cell is
+    // accessed at that type
+    ASSERT_TRUE(check_file_contains(output_file, "store double 3.000000e+00, ptr %list.slot"));
+    ASSERT_TRUE(check_file_contains(output_file, "fadd double %list.old, 1.000000e+00"));
+    ASSERT_TRUE(check_file_contains(output_file, "load i8, ptr %list.slot"));
+    ASSERT_TRUE(check_file_contains(output_file, "store i8 1, ptr %list.slot"));
+    ASSERT_FALSE(check_file_contains(output_file, "store i64 3, ptr %list.slot"));
+    
+    return 0;
+}
+
+int test_codegen_list_inline_storage() {
+    std::cout << "Running test_codegen_list_inline_storage .........";
+    
+    std::string code = "int main() { int x = 3; list<int> p = [x, 4]; return p[0] + p[1]; }";
+    std::string output_file;
+    ASSERT_TRUE(compile_code(code, output_file));
+    
+    // The header carries the slots and cells of a short list, which is not
+    // padded out to a heap capacity any more
+    ASSERT_TRUE(check_file_contains(output_file, "%ris_list_t = type { ptr, i64, i64, i32, [4 x ptr], [4 x i64] }"));
+    ASSERT_TRUE(check_file_contains(output_file, "call ptr @ris_list_create(i32 0, i64 2)"));
+    ASSERT_TRUE(check_file_contains(output_file, "dereferenceable(96)"));
+    
+    return 0;
+}
+
 // Test runner functions (will be called from test_runner.cpp)
 int test_codegen_basic_function();
 int test_codegen_void_function();
@@ -170,3 +548,17 @@ int test_codegen_boolean_literals();
 int test_codegen_float_operations();
 int test_codegen_string_literals();
 int test_codegen_error_handling();
+int test_codegen_parallel_objects();
+int test_codegen_target_cpu();
+int test_codegen_whole_program();
+int test_codegen_short_circuit();
+int test_codegen_runtime_attributes();
+int test_codegen_list_tbaa();
+int test_codegen_arithmetic_modes();
+int test_codegen_loop_hints();
+int test_codegen_function_hints();
+int test_codegen_list_literal_table();
+int test_codegen_list_element_store();
+int test_codegen_list_bulk_operations();
+int test_codegen_list_inline_storage();
+int test_codegen_list_element_store_types();
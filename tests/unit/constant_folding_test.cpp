@@ -0,0 +1,139 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include "lexer.h"
+#include "parser.h"
+#include "semantic_analyzer.h"
+#include "codegen.h"
+#include "constant_folding.h"
+
+#define ASSERT_TRUE(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << " FAIL  " #condition " is false at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+#define ASSERT_FALSE(condition) \
+    do { \
+        if (condition) { \
+            std::cerr << " FAIL  " #condition " is true at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+static ris::LiteralExpr* initializer_literal(ris::Stmt* stmt) {
+    auto* var = dynamic_cast<ris::VarDecl*>(stmt);
+    return var ? dynamic_cast<ris::LiteralExpr*>(var->initializer.get()) : nullptr;
+}
+
+int test_constant_folding() {
+    std::cout << "Running test_constant_folding .........";
+    
+    std::string code =
+        "int main() {"
+        "  int a = (2 * 4) + 1;"
+        "  string s = \"ab\" + \"cd\";"
+        "  bool b = !(1.5 < 0.5) && true;"
+        "  int z = 0;"
+        "  int d = 1 / 0 + z;"
+        "  print(s);"
+        "  return a;"
+        "}";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    ASSERT_TRUE(ris::fold_constants(*program) == 6);
+    
+    auto& body = program->functions[0]->body->statements;
+    auto* a = initializer_literal(body[0].get());
+    ASSERT_TRUE(a && a->type == ris::TokenType::INTEGER_LITERAL && a->value == "9");
+    auto* s = initializer_literal(body[1].get());
+    ASSERT_TRUE(s && s->type == ris::TokenType::STRING_LITERAL && s->value == "abcd");
+    auto* b = initializer_literal(body[2].get());
+    ASSERT_TRUE(b && b->type == ris::TokenType::TRUE);
+    // Division by zero still happens at run time
+    ASSERT_TRUE(initializer_literal(body[4].get()) == nullptr);
+    
+    ris::CodeGenerator codegen;
+    std::string output_file = "test_constant_folding.ll";
+    ASSERT_TRUE(codegen.generate(std::move(program), output_file));
+    
+    std::ifstream file(output_file);
+    std::string ir((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::remove(output_file.c_str());
+    
+    ASSERT_TRUE(ir.find("abcd") != std::string::npos);
+    ASSERT_TRUE(ir.find("call ptr @ris_string_concat") == std::string::npos);
+    
+    return 0;
+}
+
+int test_constant_folding_const_functions() {
+    std::cout << "Running test_constant_folding_const_functions .........";
+    
+    std::string code =
+        "const list<int> squares(int n) {"
+        "  list<int> result = [];"
+        "  for (int i = 0; i < n; i++) { result.push(i * i); }"
+        "  return result;"
+        "}"
+        "const int cube(int n) { return n * n * n; }"
+        "int seed() { return 7; }"
+        "list<int> table = squares(4);"
+        "int total = cube(2) + table[3];"
+        "int late = seed();"
+        "list<int> scratch = [1, 2];"
+        "list<int> flags = [0, 0];"
+        "int main() { scratch.push(table[1]); flags[1] += 1; return total + late + cube(3); }";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    ris::fold_constants(*program);
+    
+    auto& globals = program->globals;
+    auto* table = dynamic_cast<ris::ListLiteralExpr*>(globals[0]->initializer.get());
+    ASSERT_TRUE(table && table->elements.size() == 4 && globals[0]->constant_data);
+    auto* total = dynamic_cast<ris::LiteralExpr*>(globals[1]->initializer.get());
+    ASSERT_TRUE(total && total->value == "17");
+    // seed() is not const, so it still runs, at startup
+    ASSERT_TRUE(dynamic_cast<ris::CallExpr*>(globals[2]->initializer.get()) != nullptr);
+    ASSERT_FALSE(globals[3]->constant_data);
+    // Storing into an element is a write too
+    ASSERT_FALSE(globals[4]->constant_data);
+    
+    ris::CodeGenerator codegen;
+    std::string output_file = "test_constant_folding_const.ll";
+    ASSERT_TRUE(codegen.generate(std::move(program), output_file));
+    
+    std::ifstream file(output_file);
+    std::string ir((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::remove(output_file.c_str());
+    
+    ASSERT_TRUE(ir.find("@table.cells = private constant [4 x i64] [i64 0, i64 1, i64 4, i64 9]") != std::string::npos);
+    ASSERT_TRUE(ir.find("@total = internal global i64 17") != std::string::npos);
+    ASSERT_TRUE(ir.find("@llvm.global_ctors") != std::string::npos);
+    ASSERT_TRUE(ir.find("@cube(i64 3)") == std::string::npos);
+    
+    // A const function must not depend on anything but its arguments
+    ris::Lexer bad_lexer("int g = 1; const int f() { return g; } int main() { return f(); }");
+    ris::Parser bad_parser(bad_lexer.tokenize());
+    auto bad_program = bad_parser.parse();
+    ASSERT_FALSE(bad_parser.has_error());
+    ris::SemanticAnalyzer bad_analyzer;
+    ASSERT_FALSE(bad_analyzer.analyze(*bad_program));
+    
+    return 0;
+}
+
+// Test functions are defined above, main() is in test_runner.cpp
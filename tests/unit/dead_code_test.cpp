@@ -0,0 +1,57 @@
+#include <iostream>
+#include <string>
+#include "lexer.h"
+#include "parser.h"
+#include "semantic_analyzer.h"
+#include "dead_code.h"
+
+#define ASSERT_TRUE(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << " FAIL  " #condition " is false at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+#define ASSERT_FALSE(condition) \
+    do { \
+        if (condition) { \
+            std::cerr << " FAIL  " #condition " is true at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+int test_dead_code_removal() {
+    std::cout << "Running test_dead_code_removal .........";
+    
+    std::string code =
+        "int helper(int n);"
+        "int scale = 3;"
+        "int unused_table = 42;"
+        "int greeting = announce();"
+        "int announce() { print(1); return 1; }"
+        "int helper(int n) { return n * scale; }"
+        "int unused(int n) { return helper(n) + unused_table; }"
+        "int main() { return helper(2); }";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    // unused and unused_table go; greeting stays because announce prints
+    ASSERT_TRUE(ris::remove_unused_declarations(*program) == 2);
+    ASSERT_TRUE(program->functions.size() == 4);
+    for (const auto& func : program->functions) {
+        ASSERT_TRUE(func->name != "unused");
+    }
+    ASSERT_TRUE(program->globals.size() == 2);
+    ASSERT_TRUE(program->globals[0]->name == "scale");
+    ASSERT_TRUE(program->globals[1]->name == "greeting");
+    
+    return 0;
+}
+
+// Test functions are defined above, main() is in test_runner.cpp
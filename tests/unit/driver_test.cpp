@@ -0,0 +1,303 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <sys/wait.h>
+#include "driver.h"
+#include "module_build.h"
+#include "server.h"
+
+#define ASSERT_TRUE(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << " FAIL  " #condition " is false at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+#define ASSERT_FALSE(condition) \
+    do { \
+        if (condition) { \
+            std::cerr << " FAIL  " #condition " is true at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+#define ASSERT_EQ(expected, actual) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << " FAIL  " << #expected << " != " << #actual << " at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+int test_driver_batch_manifest() {
+    std::cout << "Running test_driver_batch_manifest .........";
+    
+    std::string manifest = "test_manifest.txt";
+    {
+        std::ofstream out(manifest);
+        out << "# programs to build\n";
+        out << "a.ris\n";
+        out << "\n";
+        out << "b.ris b_out\n";
+        out << "c.ris c.ll\n";
+    }
+    
+    std::vector<ris::CompileJob> jobs;
+    std::string error;
+    bool ok = ris::read_manifest(manifest, jobs, error);
+    std::remove(manifest.c_str());
+    
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(3u, jobs.size());
+    ASSERT_EQ(std::string("a.ris"), jobs[0].input_file);
+    ASSERT_TRUE(jobs[0].output_file.empty());
+    ASSERT_EQ(std::string("b_out"), jobs[1].output_file);
+    ASSERT_FALSE(jobs[1].emit_llvm);
+    ASSERT_TRUE(jobs[2].emit_llvm);
+    
+    return 0;
+}
+
+int test_driver_compile_files() {
+    std::cout << "Running test_driver_compile_files .........";
+    
+    std::vector<std::string> sources = {"test_driver_a.ris", "test_driver_b.ris"};
+    for (const auto& source : sources) {
+        std::ofstream out(source);
+        out << "int main() { return 0; }\n";
+    }
+    
+    std::vector<ris::CompileJob> jobs;
+    for (const auto& source : sources) {
+        ris::CompileJob job;
+        job.input_file = source;
+        job.output_file = source + ".ll";
+        job.emit_llvm = true;
+        jobs.push_back(job);
+    }
+    
+    ris::DriverOptions options;
+    options.jobs = 2;
+    auto results = ris::compile_files(jobs, options);
+    
+    for (const auto& source : sources) {
+        std::remove(source.c_str());
+    }
+    
+    ASSERT_EQ(2u, results.size());
+    for (const auto& result : results) {
+        ASSERT_TRUE(result.ok);
+        ASSERT_TRUE(result.errors.empty());
+        std::ifstream file(result.output_file);
+        ASSERT_TRUE(file.is_open());
+        file.close();
+        std::remove(result.output_file.c_str());
+    }
+    
+    return 0;
+}
+
+int test_driver_global_initializer_output() {
+    std::cout << "Running test_driver_global_initializer_output .........";
+    
+    // The initializer runs before main, from a constructor
+    std::string source = "test_driver_init.ris";
+    {
+        std::ofstream out(source);
+        out << "#include <std>\n"
+               "int noisy() { println(\"x\"); return 5; }\n"
+               "int g = noisy();\n"
+               "int main() { println(g); return 0; }\n";
+    }
+    
+    ris::CompileJob job;
+    job.input_file = source;
+    job.output_file = "test_driver_init";
+    ris::DriverOptions options;
+    auto result = ris::compile_file(job, options);
+    std::remove(source.c_str());
+    ASSERT_TRUE(result.ok);
+    
+    std::string output;
+    FILE* pipe = popen(("./" + job.output_file).c_str(), "r");
+    ASSERT_TRUE(pipe != nullptr);
+    char buffer[64];
+    while (fgets(buffer, sizeof(buffer), pipe)) {
+        output += buffer;
+    }
+    int status = pclose(pipe);
+    std::remove(job.output_file.c_str());
+    
+    ASSERT_EQ(0, status);
+    ASSERT_EQ(std::string("x\n5\n"), output);
+    
+    return 0;
+}
+
+int test_driver_parse_arguments() {
+    std::cout << "Running test_driver_parse_arguments .........";
+    
+    ris::Invocation invocation;
+    std::string error;
+    std::vector<std::string> args = {"--connect", "--socket", "/tmp/x.sock", "-j", "4", "a.ris", "-o", "a.ll"};
+    ASSERT_TRUE(ris::parse_arguments(args, "/work", invocation, error));
+    ASSERT_TRUE(invocation.use_server);
+    ASSERT_FALSE(invocation.start_server);
+    ASSERT_EQ(std::string("/tmp/x.sock"), invocation.socket_path);
+    ASSERT_EQ(std::string("/work"), invocation.options.working_dir);
+    ASSERT_EQ(1u, invocation.jobs.size());
+    ASSERT_TRUE(invocation.jobs[0].emit_llvm);
+    ASSERT_EQ(4u, invocation.options.codegen.jobs);
+    ASSERT_TRUE(invocation.options.codegen.pic);
+    
+    ris::Invocation static_build;
+    std::vector<std::string> static_args = {"a.ris", "--static"};
+    ASSERT_TRUE(ris::parse_arguments(static_args, "", static_build, error));
+    ASSERT_TRUE(static_build.options.static_link);
+    ASSERT_FALSE(static_build.options.codegen.pic);
+    
+    ris::Invocation several;
+    std::vector<std::string> run_many = {"a.ris", "b.ris", "--run"};
+    ASSERT_FALSE(ris::parse_arguments(run_many, "", several, error));
+    
+    // Unknown flags are usage errors, not input files
+    ris::Invocation typo;
+    std::vector<std::string> typo_args = {"a.ris", "--verbsoe"};
+    ASSERT_FALSE(ris::parse_arguments(typo_args, "", typo, error));
+    ASSERT_EQ(std::string("unknown option: --verbsoe"), error);
+    
+    ris::Invocation missing;
+    std::vector<std::string> missing_args = {"a.ris", "-o"};
+    ASSERT_FALSE(ris::parse_arguments(missing_args, "", missing, error));
+    
+    return 0;
+}
+
+int test_driver_server_socket() {
+    std::cout << "Running test_driver_server_socket .........";
+    
+    // Anyone may create files in /tmp, so a socket directly inside it is never trusted
+    ris::InvocationResult result;
+    ASSERT_FALSE(ris::run_client("/tmp/risc_test.sock", {"a.ris"}, "/work", result));
+    
+    setenv("XDG_RUNTIME_DIR", "/run/user/42", 1);
+    ASSERT_EQ(std::string("/run/user/42/risc.sock"), ris::default_socket_path());
+    unsetenv("XDG_RUNTIME_DIR");
+    ASSERT_TRUE(ris::default_socket_path().find("/tmp/risc-") == 0);
+    
+    // --run starts the executable the client named, whatever the server reports
+    ris::CompileJob job;
+    job.input_file = "src/a.ris";
+    ASSERT_EQ(std::string("/work/a"), ris::executable_path(job, "/work"));
+    job.output_file = "bin/b";
+    ASSERT_EQ(std::string("/work/bin/b"), ris::executable_path(job, "/work"));
+    
+    return 0;
+}
+
+int test_driver_build_relinks_on_link_mode() {
+    std::cout << "Running test_driver_build_relinks_on_link_mode .........";
+    
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "risc_test_build";
+    std::filesystem::create_directories(dir);
+    {
+        std::ofstream out(dir / "main.ris");
+        out << "int main() { return 7; }\n";
+    }
+    
+    // --no-pie and --static both compile position-dependent objects, so only
+    // the link mode tells the two builds apart
+    ris::CompileJob job;
+    job.input_file = "main.ris";
+    ris::DriverOptions options;
+    options.working_dir = dir.string();
+    options.verbose = true;
+    options.pie = false;
+    options.codegen.pic = false;
+    
+    auto first = ris::build_program(job, options);
+    ASSERT_TRUE(first.ok);
+    ASSERT_TRUE(first.log.find("Executable created") != std::string::npos);
+    
+    auto unchanged = ris::build_program(job, options);
+    ASSERT_TRUE(unchanged.ok);
+    ASSERT_TRUE(unchanged.log.find("is up to date") != std::string::npos);
+    
+    options.static_link = true;
+    auto relinked = ris::build_program(job, options);
+    ASSERT_TRUE(relinked.ok);
+    ASSERT_TRUE(relinked.log.find("Executable created") != std::string::npos);
+    
+    // The root unit is optimized differently without whole-program mode
+    options.codegen.whole_program = false;
+    auto recompiled = ris::build_program(job, options);
+    ASSERT_TRUE(recompiled.ok);
+    ASSERT_TRUE(recompiled.log.find("Compiling module") != std::string::npos);
+    
+    std::filesystem::remove_all(dir);
+    return 0;
+}
+
+int test_driver_build_transitive_includes() {
+    std::cout << "Running test_driver_build_transitive_includes .........";
+    
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "risc_test_build_includes";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    {
+        std::ofstream(dir / "c.ris") << "int cval() { return 5; }\n";
+        std::ofstream(dir / "a.ris") << "#include \"c.ris\"\nint aval() { return cval() + 1; }\n";
+        std::ofstream(dir / "main.ris") << "#include \"a.ris\"\n#include \"c.ris\"\n"
+                                           "int main() { return aval() + cval(); }\n";
+    }
+    
+    // main sees c.ris through a.ris, as a single-file build would, and the
+    // repeated include does not declare cval twice
+    ris::CompileJob job;
+    job.input_file = "main.ris";
+    ris::DriverOptions options;
+    options.working_dir = dir.string();
+    auto result = ris::build_program(job, options);
+    ASSERT_TRUE(result.ok);
+    
+    int status = std::system((dir / "main").string().c_str());
+    ASSERT_EQ(11, WEXITSTATUS(status));
+    
+    std::filesystem::remove_all(dir);
+    return 0;
+}
+
+int test_driver_build_const_across_units() {
+    std::cout << "Running test_driver_build_const_across_units .........";
+    
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "risc_test_build_const";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    {
+        std::ofstream(dir / "sq.ris") << "const int sq(int x) { return x * x; }\n";
+        std::ofstream(dir / "main.ris") << "#include \"sq.ris\"\n"
+                                           "const int quad(int x) { return sq(x) * sq(x); }\n"
+                                           "int main() { return quad(3); }\n";
+    }
+    
+    // The interface keeps sq const, so quad may call it
+    ris::CompileJob job;
+    job.input_file = "main.ris";
+    ris::DriverOptions options;
+    options.working_dir = dir.string();
+    auto result = ris::build_program(job, options);
+    ASSERT_TRUE(result.ok);
+    
+    int status = std::system((dir / "main").string().c_str());
+    ASSERT_EQ(81, WEXITSTATUS(status));
+    
+    std::filesystem::remove_all(dir);
+    return 0;
+}
+
+// Test functions are defined above, main() is in test_runner.cpp
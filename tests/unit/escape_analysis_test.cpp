@@ -0,0 +1,92 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include "lexer.h"
+#include "parser.h"
+#include "semantic_analyzer.h"
+#include "codegen.h"
+#include "escape_analysis.h"
+
+#define ASSERT_TRUE(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << " FAIL  " #condition " is false at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+#define ASSERT_FALSE(condition) \
+    do { \
+        if (condition) { \
+            std::cerr << " FAIL  " #condition " is true at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+namespace {
+
+ris::ListLiteralExpr* initializer(ris::BlockStmt& body, size_t index) {
+    auto* var = dynamic_cast<ris::VarDecl*>(body.statements[index].get());
+    return var ? dynamic_cast<ris::ListLiteralExpr*>(var->initializer.get()) : nullptr;
+}
+
+} // namespace
+
+int test_escape_analysis_stack_lists() {
+    std::cout << "Running test_escape_analysis_stack_lists .........";
+    
+    std::string code =
+        "int keep(list<int> xs) { return xs.size(); }"
+        "list<int> make() { list<int> r = [1]; return r; }"
+        "list<int> dup() { list<int> a = [1, 2]; a[0] = 9; return a.copy(); }"
+        "int main() {"
+        "  list<int> scratch = []; scratch.push(4); scratch[0] += 1;"
+        "  list<int> other = [2, 3]; other.extend(scratch);"
+        "  list<int> passed = [5]; keep(passed);"
+        "  list<int> stored = [6]; list<int> alias = stored;"
+        "  list<list<int>> outer = [[7]]; list<int> inner = [8]; outer.push(inner);"
+        "  print(scratch); if (scratch == other) { return 1; }"
+        "  int r = scratch[0] + alias[0] + keep(make()); return r;"
+        "}";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    // scratch, other and outer stay in main; the rest are returned, passed,
+    // copied into another variable or pushed into a list
+    ASSERT_TRUE(ris::mark_stack_lists(*program) == 3);
+    auto& body = *program->functions[3]->body;
+    ASSERT_TRUE(initializer(body, 0)->stack_allocated);
+    ASSERT_TRUE(initializer(body, 3)->stack_allocated);
+    ASSERT_FALSE(initializer(body, 5)->stack_allocated);
+    ASSERT_FALSE(initializer(body, 7)->stack_allocated);
+    ASSERT_TRUE(initializer(body, 9)->stack_allocated);
+    ASSERT_FALSE(initializer(body, 10)->stack_allocated);
+    ASSERT_FALSE(initializer(*program->functions[1]->body, 0)->stack_allocated);
+    
+    // A call in a return may become a tail call, which must not see the frame
+    ASSERT_FALSE(initializer(*program->functions[2]->body, 0)->stack_allocated);
+    
+    ris::CodeGenerator codegen;
+    std::string output_file = "test_escape_analysis.ll";
+    ASSERT_TRUE(codegen.generate(std::move(program), output_file));
+    
+    std::ifstream file(output_file);
+    std::string ir((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::remove(output_file.c_str());
+    
+    // The header lives in the frame and the runtime only initializes it
+    ASSERT_TRUE(ir.find("alloca %ris_list_t") != std::string::npos);
+    ASSERT_TRUE(ir.find("call void @ris_list_init(ptr %list.frame") != std::string::npos);
+    ASSERT_TRUE(ir.find("call void @ris_list_push_value(") != std::string::npos);
+    ASSERT_TRUE(ir.find("call ptr @ris_list_from_array(i32 0") != std::string::npos);
+    
+    return 0;
+}
+
+// Test functions are defined above, main() is in test_runner.cpp
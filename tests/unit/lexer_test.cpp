@@ -77,14 +77,16 @@ int test_lexer_keywords() {
 int test_lexer_operators() {
     std::cout << "Running test_lexer_operators .........";
     
-    ris::Lexer lexer("+ - * / % == != < > <= >= && || ! =");
+    ris::Lexer lexer("+ - * / % == != < > <= >= && || ! = += -= *= /= %=");
     auto tokens = lexer.tokenize();
     
     std::vector<ris::TokenType> expected_types = {
         ris::TokenType::PLUS, ris::TokenType::MINUS, ris::TokenType::MULTIPLY, ris::TokenType::DIVIDE,
         ris::TokenType::MODULO, ris::TokenType::EQUAL, ris::TokenType::NOT_EQUAL, ris::TokenType::LESS,
         ris::TokenType::GREATER, ris::TokenType::LESS_EQUAL, ris::TokenType::GREATER_EQUAL,
-        ris::TokenType::AND, ris::TokenType::OR, ris::TokenType::NOT, ris::TokenType::ASSIGN
+        ris::TokenType::AND, ris::TokenType::OR, ris::TokenType::NOT, ris::TokenType::ASSIGN,
+        ris::TokenType::PLUS_ASSIGN, ris::TokenType::MINUS_ASSIGN, ris::TokenType::MULTIPLY_ASSIGN,
+        ris::TokenType::DIVIDE_ASSIGN, ris::TokenType::MODULO_ASSIGN
     };
     
     ASSERT_EQ(expected_types.size() + 1, tokens.size()); // +1 for EOF
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include "driver.h"
+
+#define ASSERT_TRUE(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << " FAIL  " #condition " is false at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+#define ASSERT_EQ(expected, actual) \
+    do { \
+        if ((expected) != (actual)) { \
+            std::cerr << " FAIL  " << #expected << " != " << #actual << " at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+namespace {
+
+// A private fixture directory, removed on every exit path including failed asserts
+struct TempDir {
+    std::string path;
+    TempDir() {
+        std::string pattern = (std::filesystem::temp_directory_path() / "risc-linker-XXXXXX").string();
+        if (mkdtemp(&pattern[0]) != nullptr) {
+            path = pattern;
+        }
+    }
+    ~TempDir() {
+        if (!path.empty()) {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+    }
+};
+
+} // namespace
+
+static std::string run_output(const std::string& executable, int& status) {
+    std::string output;
+    FILE* pipe = popen(executable.c_str(), "r");
+    if (!pipe) {
+        status = -1;
+        return output;
+    }
+    char buffer[64];
+    while (fgets(buffer, sizeof(buffer), pipe)) {
+        output += buffer;
+    }
+    status = pclose(pipe);
+    return output;
+}
+
+int test_linker_links_executables() {
+    std::cout << "Running test_linker_links_executables .........";
+
+    TempDir dir;
+    ASSERT_TRUE(!dir.path.empty());
+    std::string source = dir.path + "/test_linker.ris";
+    {
+        std::ofstream out(source);
+        out << "#include <std>\n"
+               "int main() { println(42); return 0; }\n";
+    }
+
+    // Two links in one process, as a compile server does: the second must not
+    // trip over state the first left behind
+    for (bool pie : {true, false}) {
+        ris::CompileJob job;
+        job.input_file = source;
+        job.output_file = dir.path + (pie ? "/test_linker_pie" : "/test_linker_no_pie");
+        ris::DriverOptions options;
+        options.pie = pie;
+        options.codegen.pic = pie;
+        options.verbose = true;
+        auto result = ris::compile_file(job, options);
+        ASSERT_TRUE(result.ok);
+#ifdef RIS_WITH_LLD
+        ASSERT_TRUE(result.log.find("Linking in-process") != std::string::npos);
+#endif
+
+        int status = 0;
+        std::string output = run_output(job.output_file, status);
+        ASSERT_EQ(0, status);
+        ASSERT_EQ(std::string("42\n"), output);
+    }
+
+    // A failed link reports the linker's own diagnostics, which a compile
+    // server sends back to its client
+    std::ostringstream log;
+    std::ostringstream errors;
+    std::string missing = dir.path + "/missing_object.o";
+    ASSERT_TRUE(!ris::link_executable({missing}, "", dir.path + "/test_linker_missing", ris::LinkOptions(), log, errors));
+    ASSERT_TRUE(errors.str().find("missing_object.o") != std::string::npos);
+
+    return 0;
+}
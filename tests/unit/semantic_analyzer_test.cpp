@@ -409,4 +409,129 @@ int test_semantic_implicit_conversions() {
     return 0;
 }
 
+int test_semantic_parallel_function_bodies() {
+    std::cout << "Running test_semantic_parallel_function_bodies .........";
+    
+    // Forward calls resolve through the signature phase, and errors from
+    // bodies checked on different threads come back in declaration order
+    ris::Lexer lexer(R"(
+        int first() { return second(1); }
+        int second(int x) { return x + missing_a; }
+        int third() { return 3; }
+        int fourth() { int y = missing_b; return y; }
+        int main() { return first() + third(); }
+    )");
+    
+    auto tokens = lexer.tokenize();
+    ris::Parser parser(tokens);
+    auto program = parser.parse();
+    
+    ASSERT_FALSE(parser.has_error());
+    ASSERT_TRUE(program != nullptr);
+    
+    ris::SemanticAnalyzer analyzer;
+    analyzer.set_jobs(4);
+    bool result = analyzer.analyze(*program);
+    
+    ASSERT_FALSE(result);
+    ASSERT_EQ(2u, analyzer.errors().size());
+    ASSERT_TRUE(analyzer.errors()[0].find("missing_a") != std::string::npos);
+    ASSERT_TRUE(analyzer.errors()[1].find("missing_b") != std::string::npos);
+    ASSERT_TRUE(analyzer.error_message().find("missing_a") != std::string::npos);
+    
+    return 0;
+}
+
+int test_semantic_function_prototypes() {
+    std::cout << "Running test_semantic_function_prototypes .........";
+    
+    // Matching prototypes may repeat; a mismatched one or a second body may not
+    ris::Lexer lexer(R"(
+        int twice(int x);
+        int twice(int x);
+        int main() { return twice(2); }
+        int twice(int x) { return x + x; }
+    )");
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    ASSERT_TRUE(program->functions[0]->body == nullptr);
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    ris::Lexer bad_lexer("int twice(int x); float twice(int x) { return 1.0; } int main() { return 0; }");
+    ris::Parser bad_parser(bad_lexer.tokenize());
+    auto bad_program = bad_parser.parse();
+    ASSERT_FALSE(bad_parser.has_error());
+    
+    ris::SemanticAnalyzer bad_analyzer;
+    ASSERT_FALSE(bad_analyzer.analyze(*bad_program));
+    
+    return 0;
+}
+
+int test_semantic_function_purity() {
+    std::cout << "Running test_semantic_function_purity .........";
+    
+    ris::Lexer lexer(R"(
+        int g = 1;
+        int scaled(int x);
+        int square(int x) { return x * x; }
+        int twice_square(int x) { return square(x) + square(x); }
+        int scaled(int x) { return x * g; }
+        int fact(int n) { if (n <= 1) { return 1; } return n * fact(n - 1); }
+        int total(list<int> xs) { int n = 0; for (int i = 0; i < xs.size(); i++) { n = n + xs[i]; } return n; }
+        int same(list<int> a, list<int> b) { if (a == b) { return 1; } return 0; }
+        string greet(string name) { return name + "!"; }
+        void bump() { g = g + 1; }
+        int noisy(int x) { print(x); return square(x); }
+        int main() { bump(); return noisy(scaled(2)); }
+    )");
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    auto& functions = program->functions;
+    ASSERT_TRUE(functions[0]->purity == ris::FunctionPurity::ReadOnly); // Prototype follows its definition
+    ASSERT_TRUE(functions[1]->purity == ris::FunctionPurity::Pure && functions[1]->always_returns);
+    ASSERT_TRUE(functions[2]->purity == ris::FunctionPurity::Pure && functions[2]->always_returns);
+    ASSERT_TRUE(functions[3]->purity == ris::FunctionPurity::ReadOnly);
+    ASSERT_TRUE(functions[4]->purity == ris::FunctionPurity::Pure && !functions[4]->always_returns);
+    ASSERT_TRUE(functions[5]->purity == ris::FunctionPurity::ReadOnly && !functions[5]->always_returns);
+    ASSERT_TRUE(functions[6]->purity == ris::FunctionPurity::ReadOnly); // Comparing lists reads their elements
+    ASSERT_TRUE(functions[7]->purity == ris::FunctionPurity::SideEffects && !functions[7]->always_returns); // Allocating may abort
+    ASSERT_TRUE(functions[8]->purity == ris::FunctionPurity::SideEffects && functions[8]->always_returns);
+    ASSERT_TRUE(functions[9]->purity == ris::FunctionPurity::SideEffects);
+    ASSERT_TRUE(functions[10]->purity == ris::FunctionPurity::SideEffects);
+    
+    return 0;
+}
+
+int test_semantic_conflicting_loop_annotations() {
+    std::cout << "Running test_semantic_conflicting_loop_annotations .........";
+    
+    auto analyzes = [](const std::string& code) {
+        ris::Lexer lexer(code);
+        ris::Parser parser(lexer.tokenize());
+        auto program = parser.parse();
+        ris::SemanticAnalyzer analyzer;
+        return !parser.has_error() && analyzer.analyze(*program);
+    };
+    
+    ASSERT_TRUE(analyzes("int main() { @unroll(4) @no_vectorize while (false) { } return 0; }"));
+    ASSERT_TRUE(analyzes("int main() { @no_unroll @vectorize while (false) { } return 0; }"));
+    
+    // Every form of @unroll contradicts @no_unroll
+    ASSERT_FALSE(analyzes("int main() { @unroll @no_unroll while (false) { } return 0; }"));
+    ASSERT_FALSE(analyzes("int main() { @no_unroll @unroll(4) while (false) { } return 0; }"));
+    ASSERT_FALSE(analyzes("int main() { @unroll(full) @no_unroll for (int i = 0; i < 3; i++) { } return 0; }"));
+    ASSERT_FALSE(analyzes("int main() { @vectorize @no_vectorize while (false) { } return 0; }"));
+    
+    return 0;
+}
+
 // Test functions are defined above, main() is in test_runner.cpp
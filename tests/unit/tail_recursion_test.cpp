@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include "lexer.h"
+#include "parser.h"
+#include "semantic_analyzer.h"
+#include "codegen.h"
+#include "tail_recursion.h"
+
+#define ASSERT_TRUE(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << " FAIL  " #condition " is false at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+#define ASSERT_FALSE(condition) \
+    do { \
+        if (condition) { \
+            std::cerr << " FAIL  " #condition " is true at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return 1; \
+        } \
+    } while (0)
+
+int test_tail_recursion_rewrite() {
+    std::cout << "Running test_tail_recursion_rewrite .........";
+    
+    std::string code =
+        "int sum(int n, int acc) { if (n == 0) { return acc; } return sum(n - 1, acc + n); }"
+        "int loop(int n) { while (n > 0) { return loop(n - 1); } return 0; }"
+        "int main() { return sum(3, 0); }";
+    ris::Lexer lexer(code);
+    ris::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.has_error());
+    
+    ris::SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(*program));
+    
+    // A return inside a loop would continue that loop instead, so only sum qualifies
+    ASSERT_TRUE(ris::rewrite_tail_recursion(*program) == 1);
+    ASSERT_TRUE(program->functions[0]->body->statements.size() == 1);
+    ASSERT_TRUE(dynamic_cast<ris::WhileStmt*>(program->functions[0]->body->statements[0].get()) != nullptr);
+    
+    ris::CodeGenerator codegen;
+    std::string output_file = "test_tail_recursion.ll";
+    ASSERT_TRUE(codegen.generate(std::move(program), output_file));
+    
+    std::ifstream file(output_file);
+    std::string ir((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::remove(output_file.c_str());
+    
+    // sum no longer calls itself; loop keeps a guaranteed tail call
+    ASSERT_TRUE(ir.find("musttail call fastcc i64 @sum") == std::string::npos);
+    ASSERT_TRUE(ir.find("musttail call fastcc i64 @loop") != std::string::npos);
+    
+    return 0;
+}
+
+// Test functions are defined above, main() is in test_runner.cpp
@@ -50,6 +50,10 @@ int test_semantic_undefined_function();
 int test_semantic_control_flow();
 int test_semantic_scope_handling();
 int test_semantic_implicit_conversions();
+int test_semantic_parallel_function_bodies();
+int test_semantic_function_prototypes();
+int test_semantic_function_purity();
+int test_semantic_conflicting_loop_annotations();
 
 // Code generator tests
 int test_codegen_basic_function();
@@ -61,6 +65,36 @@ int test_codegen_boolean_literals();
 int test_codegen_float_operations();
 int test_codegen_string_literals();
 int test_codegen_error_handling();
+int test_codegen_parallel_objects();
+int test_codegen_target_cpu();
+int test_codegen_whole_program();
+int test_codegen_short_circuit();
+int test_codegen_runtime_attributes();
+int test_codegen_list_tbaa();
+int test_codegen_arithmetic_modes();
+int test_codegen_loop_hints();
+int test_codegen_function_hints();
+int test_codegen_list_literal_table();
+int test_codegen_list_element_store();
+int test_codegen_list_element_store_types();
+int test_codegen_list_bulk_operations();
+int test_codegen_list_inline_storage();
+int test_driver_batch_manifest();
+int test_driver_compile_files();
+int test_driver_global_initializer_output();
+int test_driver_parse_arguments();
+int test_driver_build_relinks_on_link_mode();
+int test_driver_build_transitive_includes();
+int test_driver_build_const_across_units();
+int test_driver_server_socket();
+int test_linker_links_executables();
+int test_cache_key_and_store();
+int test_cache_eviction();
+int test_tail_recursion_rewrite();
+int test_escape_analysis_stack_lists();
+int test_constant_folding();
+int test_constant_folding_const_functions();
+int test_dead_code_removal();
 int test_main_basic();
 
 // Test function structure
@@ -124,6 +158,10 @@ int main() {
         {"test_semantic_control_flow", test_semantic_control_flow},
         {"test_semantic_scope_handling", test_semantic_scope_handling},
         {"test_semantic_implicit_conversions", test_semantic_implicit_conversions},
+        {"test_semantic_parallel_function_bodies", test_semantic_parallel_function_bodies},
+        {"test_semantic_function_prototypes", test_semantic_function_prototypes},
+        {"test_semantic_function_purity", test_semantic_function_purity},
+        {"test_semantic_conflicting_loop_annotations", test_semantic_conflicting_loop_annotations},
         {"test_codegen_basic_function", test_codegen_basic_function},
         {"test_codegen_void_function", test_codegen_void_function},
         {"test_codegen_function_with_parameters", test_codegen_function_with_parameters},
@@ -133,6 +171,36 @@ int main() {
         {"test_codegen_float_operations", test_codegen_float_operations},
         {"test_codegen_string_literals", test_codegen_string_literals},
         {"test_codegen_error_handling", test_codegen_error_handling},
+        {"test_codegen_parallel_objects", test_codegen_parallel_objects},
+        {"test_codegen_target_cpu", test_codegen_target_cpu},
+        {"test_codegen_whole_program", test_codegen_whole_program},
+        {"test_codegen_short_circuit", test_codegen_short_circuit},
+        {"test_codegen_runtime_attributes", test_codegen_runtime_attributes},
+        {"test_codegen_list_tbaa", test_codegen_list_tbaa},
+        {"test_codegen_arithmetic_modes", test_codegen_arithmetic_modes},
+        {"test_codegen_loop_hints", test_codegen_loop_hints},
+        {"test_codegen_function_hints", test_codegen_function_hints},
+        {"test_codegen_list_literal_table", test_codegen_list_literal_table},
+        {"test_codegen_list_element_store", test_codegen_list_element_store},
+        {"test_codegen_list_element_store_types", test_codegen_list_element_store_types},
+        {"test_codegen_list_bulk_operations", test_codegen_list_bulk_operations},
+        {"test_codegen_list_inline_storage", test_codegen_list_inline_storage},
+        {"test_driver_batch_manifest", test_driver_batch_manifest},
+        {"test_driver_compile_files", test_driver_compile_files},
+        {"test_driver_global_initializer_output", test_driver_global_initializer_output},
+        {"test_driver_parse_arguments", test_driver_parse_arguments},
+        {"test_driver_build_relinks_on_link_mode", test_driver_build_relinks_on_link_mode},
+        {"test_driver_build_transitive_includes", test_driver_build_transitive_includes},
+        {"test_driver_build_const_across_units", test_driver_build_const_across_units},
+        {"test_driver_server_socket", test_driver_server_socket},
+        {"test_linker_links_executables", test_linker_links_executables},
+        {"test_cache_key_and_store", test_cache_key_and_store},
+        {"test_cache_eviction", test_cache_eviction},
+        {"test_tail_recursion_rewrite", test_tail_recursion_rewrite},
+        {"test_escape_analysis_stack_lists", test_escape_analysis_stack_lists},
+        {"test_constant_folding", test_constant_folding},
+        {"test_constant_folding_const_functions", test_constant_folding_const_functions},
+        {"test_dead_code_removal", test_dead_code_removal},
         {"test_diagnostics", test_diagnostics}
     };
     